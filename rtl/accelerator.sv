@@ -1,7 +1,23 @@
 // SHA256 Accelerator Core
-module accelerator (
+// ONLINE_SCHEDULE = 1: message schedule computed on the fly from a 16-word sliding window
+//                      (LOAD → COMPRESS, ~66 cycles per block, no m[] array)
+// ONLINE_SCHEDULE = 0: original LOAD → EXPAND → COMPRESS flow with the full schedule,
+//                      W[0..15] in registers and W[16..63] in LUTRAM (one write per cycle)
+// ROUNDS_PER_CYCLE   : compression rounds chained per clock (1, 2, 4 or 8)
+// SHARED_K        = 1: round constants come from an accelerator_krom port shared with other
+//                      cores (k_addr/k_word) instead of this core's own K ROM
+// Every register is clock-enabled only while a block is queued or running, so an idle core
+// holds still; GO raises the enable in the same cycle. enable = 0 parks the core (a running
+// block resumes when it is set again). CLOCK_GATE = 1 puts the same enable on a BUFGCE
+module accelerator #(
+    parameter ONLINE_SCHEDULE  = 1,
+    parameter ROUNDS_PER_CYCLE = 1,
+    parameter SHARED_K         = 0,
+    parameter CLOCK_GATE       = 0
+) (
     input  logic         clk,         // Clock input
     input  logic         wb_rst_i,    // Reset signal (active high)
+    input  logic         enable,      // Core enabled (accelerator_regs REG_CORE_ENABLE)
 
     input  logic [31:0]  control,     // Control signal: GO bit triggers the computation
     output logic         overflow,    // Not used here (always 0)
@@ -9,7 +25,13 @@ module accelerator (
 
     input  logic [31:0]  msg_word [0:15],   // 512-bit message block (16 x 32-bit words)
     input  logic [31:0]  state_in [0:7],    // Initial SHA256 state (8 x 32-bit words)
-    output logic [31:0]  state_out [0:7]    // Output SHA256 state (after processing one block)
+    output logic [31:0]  state_out [0:7],   // Output SHA256 state (after processing one block)
+
+    output logic [2:0]   fsm_state,   // Current FSM state (state_t), for the performance counters
+
+    // Round constants (SHARED_K = 1), registered read one cycle after k_addr
+    output logic [5:0]   k_addr,                         // First round of the next cycle
+    input  logic [31:0]  k_word [0:ROUNDS_PER_CYCLE-1]   // K[k_addr + r] from the previous cycle
 );
 
 // GO bit position in the control register
@@ -20,13 +42,38 @@ wire go = control[GO_BIT];
 
 // Internal latch to track start signal (GO)
 logic go_latched;
-always_ff @(posedge clk or posedge wb_rst_i) begin
+
+// FSM states for SHA256 processing
+typedef enum logic [2:0] {
+    IDLE,       // Waiting for GO
+    LOAD,       // Load message + state
+    EXPAND,     // Expand 16 message words to 64
+    COMPRESS,   // 64 compression rounds
+    DONE        // Finalize and write output
+} state_t;
+state_t state;
+
+// ---- Clock enable ----
+// Idle with nothing queued: no register changes, so the core takes no clock.
+// done always gets the edge that ends its pulse, even on a disabled core
+wire ce = (enable && (go || go_latched || state != IDLE)) || done;
+wire core_clk;
+
+if (CLOCK_GATE) begin : g_bufgce
+    BUFGCE gate (.I(clk), .CE(ce), .O(core_clk));
+end else begin : g_no_bufgce
+    assign core_clk = clk;
+end
+
+always_ff @(posedge core_clk or posedge wb_rst_i) begin
     if (wb_rst_i)
         go_latched <= 0;                        // Reset: clear GO latch
-    else if (go && state == IDLE)
-        go_latched <= 1;                        // Latch GO if we’re in IDLE
-    else if (state == DONE)
-        go_latched <= 0;                        // Clear latch after we’re DONE
+    else if (ce) begin
+        if (go && state == IDLE && !done)
+            go_latched <= 1;                    // Latch GO if we’re in IDLE (GO is still high while done pulses)
+        else if (state == DONE)
+            go_latched <= 0;                    // Clear latch after we’re DONE
+    end
 end
 
 // Working registers (SHA256 requires 8 temp variables)
@@ -35,28 +82,42 @@ logic [31:0] a, b, c, d, e, f, g, h;
 // Temporary variables used in compression step
 logic [31:0] t1, t2;
 
+// Working copies chained through the unrolled rounds of one cycle
+logic [31:0] ta, tb, tc, td, te, tf, tg, th;
+
+// Schedule window extended by the ROUNDS_PER_CYCLE words produced this cycle
+logic [31:0] ww [0:15+ROUNDS_PER_CYCLE];
+
 // Constants (K values from SHA256 spec)
 logic [31:0] k [0:63];
 
-// Message schedule array (m[0..63])
-logic [31:0] m [0:63];
+// Message schedule, only used when ONLINE_SCHEDULE = 0: W[0..15] latched in
+// LOAD, W[16..63] written one word per EXPAND cycle so it maps to LUTRAM
+logic [31:0] m_lo [0:15];
+(* ram_style = "distributed" *)
+logic [31:0] m [16:63];
+logic [31:0] m_new;
+
+// Sliding message schedule window (w[0] = W[round]), only used when ONLINE_SCHEDULE = 1
+logic [31:0] w [0:15];
 
 // Round counter (0–63)
 logic [6:0] round;
 
-// FSM states for SHA256 processing
-typedef enum logic [2:0] {
-    IDLE,       // Waiting for GO
-    LOAD,       // Load message + state
-    EXPAND,     // Expand 16 message words to 64
-    COMPRESS,   // 64 compression rounds
-    DONE        // Finalize and write output
-} state_t;
-state_t state;
-
 // Overflow not used here
 assign overflow = 1'b0;
 
+assign fsm_state = state;
+
+// The registered K read returns the constants of round k_addr in the next cycle.
+// The ROM keeps its clock while the core is parked, so it re-reads the current
+// round until ce comes back
+assign k_addr = (state != COMPRESS) ? 6'd0 :
+                ce                  ? 6'(round + ROUNDS_PER_CYCLE) : 6'(round);
+
+if (ROUNDS_PER_CYCLE < 1 || ROUNDS_PER_CYCLE > 8 || 64 % ROUNDS_PER_CYCLE != 0)
+    $error("accelerator: ROUNDS_PER_CYCLE must be 1, 2, 4 or 8");
+
 // ---- SHA256 Constants ----
 initial begin
     k[ 0] = 32'h428a2f98; k[ 1] = 32'h71374491; k[ 2] = 32'hb5c0fbcf; k[ 3] = 32'he9b5dba5;
@@ -108,13 +169,27 @@ function logic [31:0] SIG1(input logic [31:0] x);
     return ROTR(x,17) ^ ROTR(x,19) ^ (x >> 10);
 endfunction
 
+// Schedule word W[i] (ONLINE_SCHEDULE = 0)
+function logic [31:0] MW(input logic [6:0] i);
+    return (i < 16) ? m_lo[i[3:0]] : m[i[5:0]];
+endfunction
+
+// ---- Message schedule RAM (ONLINE_SCHEDULE = 0) ----
+// Kept out of the reset block: one write port and asynchronous reads map it to LUTRAM
+always_comb m_new = SIG1(MW(round-2)) + MW(round-7) + SIG0(MW(round-15)) + MW(round-16);
+
+always_ff @(posedge core_clk) begin
+    if (ce && !ONLINE_SCHEDULE && state == EXPAND && round < 64)
+        m[round[5:0]] <= m_new;
+end
+
 // ---- SHA256 FSM ----
-always_ff @(posedge clk or posedge wb_rst_i) begin
+always_ff @(posedge core_clk or posedge wb_rst_i) begin
     if (wb_rst_i) begin
         done <= 0;
         round <= 0;
         state <= IDLE;
-    end else begin
+    end else if (ce) begin
         done <= 0;  // Default
 
         case (state)
@@ -124,24 +199,28 @@ always_ff @(posedge clk or posedge wb_rst_i) begin
             end
 
             LOAD: begin
-                // Clear entire m[] array
-                for (int i = 0; i < 64; i++) m[i] <= 32'h0;
+                if (ONLINE_SCHEDULE) begin
+                    // Load the schedule window; W[16..63] are produced during COMPRESS
+                    for (int i = 0; i < 16; i++) w[i] <= msg_word[i];
+
+                    round <= 0;
+                    state <= COMPRESS;
+                end else begin
+                    // Load first 16 words from input; W[16..63] are all written before use
+                    for (int i = 0; i < 16; i++) m_lo[i] <= msg_word[i];
 
-                // Load first 16 words from input
-                for (int i = 0; i < 16; i++) m[i] <= msg_word[i];
+                    round <= 16;  // Next: compute m[16] to m[63]
+                    state <= EXPAND;
+                end
 
                 // Initialize working variables (a-h) from input state
                 a <= state_in[0]; b <= state_in[1]; c <= state_in[2]; d <= state_in[3];
                 e <= state_in[4]; f <= state_in[5]; g <= state_in[6]; h <= state_in[7];
-
-                round <= 16;  // Next: compute m[16] to m[63]
-                state <= EXPAND;
             end
 
             EXPAND: begin
                 if (round < 64) begin
-                    // Compute the extended message schedule
-                    m[round] <= SIG1(m[round-2]) + m[round-7] + SIG0(m[round-15]) + m[round-16];
+                    // Extended message schedule word (m_new) goes to the schedule RAM
                     round <= round + 1;
                 end else begin
                     round <= 0;
@@ -150,25 +229,38 @@ always_ff @(posedge clk or posedge wb_rst_i) begin
             end
 
             COMPRESS: begin
-                if (round < 64) begin
-                    // Perform one round of SHA256 compression
-                    t1 = h + EP1(e) + CH(e,f,g) + k[round] + m[round];
-                    t2 = EP0(a) + MAJ(a,b,c);
+                // Extend the schedule window by the words needed for this cycle's rounds
+                for (int i = 0; i < 16; i++) ww[i] = w[i];
+                for (int j = 0; j < ROUNDS_PER_CYCLE; j++)
+                    ww[16+j] = SIG1(ww[14+j]) + ww[9+j] + SIG0(ww[1+j]) + ww[j];
+
+                // Perform ROUNDS_PER_CYCLE rounds of SHA256 compression
+                ta = a; tb = b; tc = c; td = d; te = e; tf = f; tg = g; th = h;
+                for (int r = 0; r < ROUNDS_PER_CYCLE; r++) begin
+                    t1 = th + EP1(te) + CH(te,tf,tg) + (SHARED_K ? k_word[r] : k[round+r])
+                       + (ONLINE_SCHEDULE ? ww[r] : MW(round+r));
+                    t2 = EP0(ta) + MAJ(ta,tb,tc);
 
                     // Shift values and update working variables
-                    h <= g;
-                    g <= f;
-                    f <= e;
-                    e <= d + t1;
-                    d <= c;
-                    c <= b;
-                    b <= a;
-                    a <= t1 + t2;
+                    th = tg;
+                    tg = tf;
+                    tf = te;
+                    te = td + t1;
+                    td = tc;
+                    tc = tb;
+                    tb = ta;
+                    ta = t1 + t2;
+                end
+                a <= ta; b <= tb; c <= tc; d <= td; e <= te; f <= tf; g <= tg; h <= th;
 
-                    round <= round + 1;
-                end else begin
-                    state <= DONE;
+                if (ONLINE_SCHEDULE) begin
+                    // Slide the window past the consumed words
+                    for (int i = 0; i < 16; i++) w[i] <= ww[i+ROUNDS_PER_CYCLE];
                 end
+
+                round <= round + ROUNDS_PER_CYCLE;
+                if (round == 64 - ROUNDS_PER_CYCLE)
+                    state <= DONE;  // Last rounds, finalize next cycle
             end
 
             DONE: begin
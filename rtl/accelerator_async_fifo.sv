@@ -0,0 +1,106 @@
+// =====================================
+// Asynchronous FIFO (clock-domain crossing)
+// - wr_* side on wr_clk, rd_* side on rd_clk, no relation between the clocks
+// - Pointers cross as Gray code through two-flop synchronizers, so full and
+//   empty are conservative: an entry shows up on the other side two or
+//   three clocks after it was written or read
+// - First-word-fall-through: rd_data shows the head entry while !empty; the
+//   entry is only overwritten after the pop has crossed back
+// - Storage has no reset and a single write port, so it maps to LUTRAM
+// - DEPTH must be a power of two
+// =====================================
+module accelerator_async_fifo #(
+	parameter WIDTH = 32,
+	parameter DEPTH = 4
+) (
+	input	logic					wr_clk,
+	input	logic					wr_rst,     // Asynchronous, released in step with wr_clk
+	input	logic					wr_en,      // Push wr_data (ignored when full)
+	input	logic	[WIDTH-1:0]		wr_data,
+	output	logic					full,
+
+	input	logic					rd_clk,
+	input	logic					rd_rst,     // Asynchronous, released in step with rd_clk
+	input	logic					rd_en,      // Pop the head entry (ignored when empty)
+	output	logic	[WIDTH-1:0]		rd_data,
+	output	logic					empty
+);
+
+localparam AW = $clog2(DEPTH);
+
+if (DEPTH < 2 || (1 << AW) != DEPTH)
+	$error("accelerator_async_fifo: DEPTH must be a power of two >= 2");
+
+function logic [AW:0] BIN2GRAY(input logic [AW:0] b);
+	return b ^ (b >> 1);
+endfunction
+
+function logic [AW:0] GRAY2BIN(input logic [AW:0] g);
+	logic [AW:0] b;
+	b[AW] = g[AW];
+	for (int i = AW - 1; i >= 0; i--)
+		b[i] = b[i+1] ^ g[i];
+	return b;
+endfunction
+
+(* ram_style = "distributed" *)
+logic [WIDTH-1:0]	mem [0:DEPTH-1];
+
+logic [AW:0]	wr_bin, wr_gray;     // One extra bit tells full from empty
+logic [AW:0]	rd_bin, rd_gray;
+
+(* ASYNC_REG = "TRUE" *) logic [AW:0]	rd_gray_s0, rd_gray_s1;  // Read pointer in wr_clk
+(* ASYNC_REG = "TRUE" *) logic [AW:0]	wr_gray_s0, wr_gray_s1;  // Write pointer in rd_clk
+
+wire [AW:0]	rd_seen = GRAY2BIN(rd_gray_s1);
+
+wire push = wr_en && !full;
+wire pop  = rd_en && !empty;
+
+assign full    = (wr_bin[AW-1:0] == rd_seen[AW-1:0]) && (wr_bin[AW] != rd_seen[AW]);
+assign empty   = (rd_gray == wr_gray_s1);
+assign rd_data = mem[rd_bin[AW-1:0]];
+
+// ----------------------------------
+// Write side
+// ----------------------------------
+always_ff @(posedge wr_clk)
+	if (push)
+		mem[wr_bin[AW-1:0]] <= wr_data;
+
+always_ff @(posedge wr_clk or posedge wr_rst) begin
+	if (wr_rst) begin
+		wr_bin     <= 0;
+		wr_gray    <= 0;
+		rd_gray_s0 <= 0;
+		rd_gray_s1 <= 0;
+	end else begin
+		if (push) begin
+			wr_bin  <= wr_bin + 1'b1;
+			wr_gray <= BIN2GRAY(wr_bin + 1'b1);
+		end
+		rd_gray_s0 <= rd_gray;
+		rd_gray_s1 <= rd_gray_s0;
+	end
+end
+
+// ----------------------------------
+// Read side
+// ----------------------------------
+always_ff @(posedge rd_clk or posedge rd_rst) begin
+	if (rd_rst) begin
+		rd_bin     <= 0;
+		rd_gray    <= 0;
+		wr_gray_s0 <= 0;
+		wr_gray_s1 <= 0;
+	end else begin
+		if (pop) begin
+			rd_bin  <= rd_bin + 1'b1;
+			rd_gray <= BIN2GRAY(rd_bin + 1'b1);
+		end
+		wr_gray_s0 <= wr_gray;
+		wr_gray_s1 <= wr_gray_s0;
+	end
+end
+
+endmodule
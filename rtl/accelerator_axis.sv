@@ -0,0 +1,299 @@
+// =====================================
+// SHA256 AXI4-Stream Front End
+// - Alternative top level to accelerator_top for platforms that deliver the
+//   message bytes as a stream (NIC or DMA block); no CPU in the data path
+// - s_axis: one packet (TLAST-framed) per message, DATA_W = 64 or 128, byte 0
+//   in tdata[7:0]; TKEEP is only partial on the TLAST beat (low bytes valid)
+// - Beats are packed into 64-byte blocks in a staging buffer; the last block
+//   of a packet goes through accelerator_pad, which adds the padding and the
+//   bit length (and a length-only block if it does not fit)
+// - Packets are dealt to the cores round-robin; every core has two block
+//   banks like a register file window, so a core hashes one block while the
+//   next is handed over, and its blocks chain on its own result
+// - m_axis: one 256-bit beat per packet (digest byte 0 in tdata[7:0], TLAST
+//   set), in packet order; a digest waiting on TREADY holds only its core
+// =====================================
+module accelerator_axis #(
+	parameter NUM_CORES = 2,          // Cores the packets are spread over (1-16)
+	parameter DATA_W = 64,            // s_axis_tdata width (64 or 128)
+	parameter ONLINE_SCHEDULE = 1,
+	parameter ROUNDS_PER_CYCLE = 1,
+	parameter SHARED_K = 0            // 1: K constants from accelerator_krom, one port per core
+) (
+	input	logic					aclk,
+	input	logic					aresetn,
+
+	// Message stream
+	input	logic	[DATA_W-1:0]	s_axis_tdata,
+	input	logic	[DATA_W/8-1:0]	s_axis_tkeep,
+	input	logic					s_axis_tlast,
+	input	logic					s_axis_tvalid,
+	output	logic					s_axis_tready,
+
+	// Digest stream
+	output	logic	[255:0]			m_axis_tdata,
+	output	logic	[31:0]			m_axis_tkeep,
+	output	logic					m_axis_tlast,
+	output	logic					m_axis_tvalid,
+	input	logic					m_axis_tready
+);
+
+// ----------------------------------
+// Constants
+// ----------------------------------
+localparam DB = DATA_W / 8;         // Bytes per beat
+localparam DW = DATA_W / 32;        // Message words per beat
+localparam CW = (NUM_CORES > 1) ? $clog2(NUM_CORES) : 1;
+
+localparam logic [31:0] SHA256_IV [0:7] = '{
+	32'h6a09e667, 32'hbb67ae85, 32'h3c6ef372, 32'ha54ff53a,
+	32'h510e527f, 32'h9b05688c, 32'h1f83d9ab, 32'h5be0cd19
+};
+
+if (NUM_CORES < 1 || NUM_CORES > 16)
+	$error("accelerator_axis: NUM_CORES must be between 1 and 16");
+if (DATA_W != 64 && DATA_W != 128)
+	$error("accelerator_axis: DATA_W must be 64 or 128");
+
+function logic [31:0] BSWAP(input logic [31:0] x);
+	return {x[7:0], x[15:8], x[23:16], x[31:24]};
+endfunction
+
+wire rst = !aresetn;
+
+// ----------------------------------
+// Staging buffer
+// ----------------------------------
+// Collects one block. A full block is handed to the packet's core as soon
+// as that core has a free bank; in the same cycle the buffer takes the next
+// beat. After the last beat the buffer may produce up to two more blocks
+// without input: the padding block of a 64-byte-aligned packet and the
+// length block when the bit length did not fit.
+logic	[31:0]		stage_msg [0:15];
+logic	[6:0]		stage_bytes;    // Bytes in stage_msg (0-64)
+logic				stage_full;     // Block ready for hand-over
+logic				stage_first;    // Block starts a packet (state_in = IV)
+logic				stage_last;     // Packet ends in this block: pad it
+logic				stage_tail;     // Block is the length-only block
+logic				pad_pending;    // Packet ended on a block boundary: padding block next
+logic	[63:0]		pkt_bits;       // Bit length of the packet so far
+logic	[CW-1:0]	in_core;        // Core of the packet being received
+
+logic	[31:0]		pad_msg [0:15];
+logic				pad_need_tail;
+
+accelerator_pad pad (
+	.msg_in		(stage_msg),
+	.nbytes		(stage_bytes[5:0]),
+	.bitlen		(pkt_bits),
+	.msg_out	(pad_msg),
+	.need_tail	(pad_need_tail)
+);
+
+logic	[31:0]		hand_msg [0:15];
+logic				hand_final;     // Hand-over ends the packet
+logic				hand_follow;    // Another block without input follows this one
+logic	[NUM_CORES-1:0]	lane_free;  // Fill bank of the core is free
+logic	[6:0]		beat_bytes;
+
+wire hand = stage_full && lane_free[in_core];
+wire beat = s_axis_tvalid && s_axis_tready;
+
+assign hand_final    = stage_tail || (stage_last && !pad_need_tail);
+assign hand_follow   = pad_pending || (stage_last && !stage_tail && pad_need_tail);
+assign s_axis_tready = !stage_full || (hand && !hand_follow);
+
+always_comb begin
+	beat_bytes = 7'd0;
+	for (int i = 0; i < DB; i++)
+		beat_bytes += 7'(s_axis_tkeep[i]);
+
+	for (int i = 0; i < 16; i++)
+		hand_msg[i] = stage_tail ? ((i == 14) ? pkt_bits[63:32] : (i == 15) ? pkt_bits[31:0] : 32'h0)
+		            : stage_last ? pad_msg[i] : stage_msg[i];
+end
+
+always_ff @(posedge aclk or posedge rst) begin
+	if (rst) begin
+		foreach (stage_msg[i]) stage_msg[i] <= 32'h0;
+		stage_bytes <= 7'd0;
+		stage_full  <= 1'b0;
+		stage_first <= 1'b1;
+		stage_last  <= 1'b0;
+		stage_tail  <= 1'b0;
+		pad_pending <= 1'b0;
+		pkt_bits    <= 64'd0;
+		in_core     <= '0;
+	end else begin
+		logic [6:0]		base;
+		logic [63:0]	bits;
+
+		base = stage_bytes;
+		bits = pkt_bits;
+
+		if (hand) begin
+			if (pad_pending) begin              // Padding block of an aligned packet
+				stage_bytes <= 7'd0;
+				stage_last  <= 1'b1;
+				pad_pending <= 1'b0;
+			end else if (hand_follow) begin     // Length block
+				stage_tail  <= 1'b1;
+			end else begin                      // Buffer empty again
+				stage_full  <= 1'b0;
+				stage_last  <= 1'b0;
+				stage_tail  <= 1'b0;
+				stage_bytes <= 7'd0;
+				base = 7'd0;
+			end
+			stage_first <= hand_final;
+			if (hand_final) begin               // Next packet goes to the next core
+				bits = 64'd0;
+				in_core <= (in_core == CW'(NUM_CORES - 1)) ? '0 : in_core + 1'b1;
+			end
+		end
+
+		if (beat) begin
+			for (int i = 0; i < DW; i++)
+				stage_msg[base[5:2] + i] <= BSWAP(s_axis_tdata[32*i +: 32]);
+			stage_bytes <= base + beat_bytes;
+			bits = bits + {54'd0, beat_bytes, 3'b000};
+			if (s_axis_tlast) begin
+				stage_full  <= 1'b1;
+				pad_pending <= (base + beat_bytes == 7'd64);
+				stage_last  <= (base + beat_bytes != 7'd64);
+			end else if (base + beat_bytes == 7'd64)
+				stage_full  <= 1'b1;
+		end
+
+		pkt_bits <= bits;
+	end
+end
+
+// ----------------------------------
+// Cores
+// ----------------------------------
+// A bank is queued with its first/last flags; control stays high while the
+// bank runs. Blocks of the next packet run while a digest waits in lane_res,
+// but its last block only starts once that digest has left on m_axis.
+logic	[31:0]	lane_msg   [0:NUM_CORES-1][0:1][0:15];
+logic	[1:0]	lane_valid [0:NUM_CORES-1];
+logic	[1:0]	lane_first [0:NUM_CORES-1];
+logic	[1:0]	lane_last  [0:NUM_CORES-1];
+logic	[NUM_CORES-1:0]	lane_wr, lane_rd;
+logic	[31:0]	lane_state [0:NUM_CORES-1][0:7];  // Result of the core's last block
+logic	[31:0]	lane_res   [0:NUM_CORES-1][0:7];  // Digest of the core's last packet
+logic	[NUM_CORES-1:0]	res_valid;                // lane_res waits for m_axis
+
+logic	[31:0]	control    [0:NUM_CORES-1];
+logic	[31:0]	msg_word   [0:NUM_CORES-1][0:15];
+logic	[31:0]	state_in   [0:NUM_CORES-1][0:7];
+logic	[31:0]	state_out  [0:NUM_CORES-1][0:7];
+logic	[NUM_CORES-1:0]	done;
+logic	[5:0]	k_addr     [0:NUM_CORES-1];
+logic	[31:0]	k_word     [0:NUM_CORES-1][0:ROUNDS_PER_CYCLE-1];
+
+logic	[CW-1:0]	out_core;   // Core of the next digest in packet order
+
+always_comb begin
+	for (int i = 0; i < NUM_CORES; i++) begin
+		lane_free[i] = !lane_valid[i][lane_wr[i]];
+		control[i]   = {31'b0, lane_valid[i][lane_rd[i]] && !(lane_last[i][lane_rd[i]] && res_valid[i])};
+		msg_word[i]  = lane_msg[i][lane_rd[i]];
+		state_in[i]  = lane_first[i][lane_rd[i]] ? SHA256_IV : lane_state[i];
+	end
+end
+
+wire out_pop = m_axis_tvalid && m_axis_tready;
+
+always_ff @(posedge aclk or posedge rst) begin
+	if (rst) begin
+		foreach (lane_msg[i,b,j]) lane_msg[i][b][j] <= 32'h0;
+		foreach (lane_valid[i]) lane_valid[i] <= 2'b00;
+		foreach (lane_first[i]) lane_first[i] <= 2'b00;
+		foreach (lane_last[i]) lane_last[i] <= 2'b00;
+		lane_wr <= '0;
+		lane_rd <= '0;
+		foreach (lane_state[i,j]) lane_state[i][j] <= 32'h0;
+		foreach (lane_res[i,j]) lane_res[i][j] <= 32'h0;
+		res_valid <= '0;
+		out_core  <= '0;
+	end else begin
+		if (hand) begin                         // Staging buffer into the fill bank
+			lane_msg[in_core][lane_wr[in_core]]   <= hand_msg;
+			lane_valid[in_core][lane_wr[in_core]] <= 1'b1;
+			lane_first[in_core][lane_wr[in_core]] <= stage_first;
+			lane_last[in_core][lane_wr[in_core]]  <= hand_final;
+			lane_wr[in_core] <= ~lane_wr[in_core];
+		end
+
+		for (int i = 0; i < NUM_CORES; i++) begin
+			if (done[i]) begin
+				lane_valid[i][lane_rd[i]] <= 1'b0;
+				lane_rd[i] <= ~lane_rd[i];
+				lane_state[i] <= state_out[i];
+				if (lane_last[i][lane_rd[i]]) begin
+					lane_res[i]  <= state_out[i];
+					res_valid[i] <= 1'b1;
+				end
+			end
+		end
+
+		if (out_pop) begin
+			res_valid[out_core] <= 1'b0;
+			out_core <= (out_core == CW'(NUM_CORES - 1)) ? '0 : out_core + 1'b1;
+		end
+	end
+end
+
+for (genvar i = 0; i < NUM_CORES; i++) begin : g_core
+	accelerator #(
+		.ONLINE_SCHEDULE	(ONLINE_SCHEDULE),
+		.ROUNDS_PER_CYCLE	(ROUNDS_PER_CYCLE),
+		.SHARED_K			(SHARED_K)
+	) accelerator (
+		.clk		(aclk),
+		.wb_rst_i	(rst),
+		.enable		(1'b1),              // Gates itself while idle
+		.control	(control[i]),
+		.done		(done[i]),
+		.overflow	(),
+		.msg_word	(msg_word[i]),
+		.state_in	(state_in[i]),
+		.state_out	(state_out[i]),
+		.fsm_state	(),
+		.k_addr		(k_addr[i]),
+		.k_word		(k_word[i])
+	);
+end
+
+if (SHARED_K) begin : g_krom
+	accelerator_krom #(
+		.PORTS				(NUM_CORES),
+		.ROUNDS_PER_CYCLE	(ROUNDS_PER_CYCLE),
+		.ROM_STYLE			("block")
+	) krom (
+		.clk		(aclk),
+		.addr		(k_addr),
+		.k_word		(k_word)
+	);
+end else begin : g_no_krom
+	for (genvar i = 0; i < NUM_CORES; i++) begin : g_tie
+		for (genvar r = 0; r < ROUNDS_PER_CYCLE; r++) begin : g_word
+			assign k_word[i][r] = 32'h0;
+		end
+	end
+end
+
+// ----------------------------------
+// Digest stream
+// ----------------------------------
+always_comb begin
+	for (int i = 0; i < 8; i++)
+		m_axis_tdata[32*i +: 32] = BSWAP(lane_res[out_core][i]);
+end
+
+assign m_axis_tkeep  = 32'hFFFF_FFFF;
+assign m_axis_tlast  = 1'b1;
+assign m_axis_tvalid = res_valid[out_core];
+
+endmodule
@@ -0,0 +1,213 @@
+// =====================================
+// SHA256 Core in its own Clock Domain
+// - Same ports as accelerator on the register file side (clk), the core
+//   itself runs on core_clk
+// - A queued block ({msg_word, state_in}) crosses in an asynchronous FIFO
+//   and stays at the FIFO head until the core finishes it, because the core
+//   reads state_in again in DONE
+// - The result crosses back in a second FIFO; popping it raises done for
+//   one clk cycle with state_out already valid, as the core does
+// - One block is in flight at a time, like the register file hands them
+//   out: the next bank is only presented after done
+// - fsm_state only feeds the performance counters, which then count in clk
+//   cycles. The 3-bit state changes several bits at once (COMPRESS -> DONE),
+//   so it crosses as a held sample with a req/ack toggle handshake: clk only
+//   takes fsm_hold while it is stable, and never sees a state that did not
+//   occur. It is a fresh sample every few cycles, not a cycle-exact trace
+// - k_addr / k_word belong to core_clk (SHARED_K ROM on the core clock)
+// - enable is synchronized into core_clk; idle gating is local to the core
+// =====================================
+module accelerator_cdc #(
+	parameter ONLINE_SCHEDULE  = 1,
+	parameter ROUNDS_PER_CYCLE = 1,
+	parameter SHARED_K         = 0,
+	parameter CLOCK_GATE       = 0
+) (
+	input	logic			clk,          // Register file clock
+	input	logic			wb_rst_i,
+	input	logic			core_clk,     // Core clock
+	input	logic			enable,       // Core enabled (clk domain)
+
+	// Register file side, as accelerator
+	input	logic	[31:0]	control,
+	output	logic			overflow,
+	output	logic			done,
+	input	logic	[31:0]	msg_word  [0:15],
+	input	logic	[31:0]	state_in  [0:7],
+	output	logic	[31:0]	state_out [0:7],
+	output	logic	[2:0]	fsm_state,
+
+	// Round constants, core_clk domain
+	output	logic	[5:0]	k_addr,
+	input	logic	[31:0]	k_word [0:ROUNDS_PER_CYCLE-1]
+);
+
+// ----------------------------------
+// Constants
+// ----------------------------------
+localparam GO_BIT  = 0;
+localparam REQ_W   = 24 * 32;       // msg_word, state_in
+localparam RES_W   = 8 * 32;        // state_out
+localparam DEPTH   = 2;             // One block in flight, one spare
+
+// ----------------------------------
+// Reset synchronizer: asserted with wb_rst_i, released on core_clk
+// ----------------------------------
+(* ASYNC_REG = "TRUE" *) logic [1:0]	core_rst_s;
+wire core_rst = core_rst_s[1];
+
+always_ff @(posedge core_clk or posedge wb_rst_i)
+	if (wb_rst_i) core_rst_s <= 2'b11;
+	else          core_rst_s <= {core_rst_s[0], 1'b0};
+
+(* ASYNC_REG = "TRUE" *) logic [1:0]	core_en_s;
+
+always_ff @(posedge core_clk or posedge wb_rst_i)
+	if (wb_rst_i) core_en_s <= 2'b11;
+	else          core_en_s <= {core_en_s[0], enable};
+
+// ----------------------------------
+// Register file side
+// ----------------------------------
+logic					sent;       // Presented block is on its way or hashing
+logic	[REQ_W-1:0]		req_in;
+logic					req_full;
+logic	[RES_W-1:0]		res_out;
+logic					res_empty;
+
+wire req_push = control[GO_BIT] && !sent && !req_full;
+wire res_pop  = !res_empty;
+
+always_comb begin
+	for (int i = 0; i < 16; i++)
+		req_in[REQ_W - 1 - 32*i -: 32] = msg_word[i];
+	for (int i = 0; i < 8; i++)
+		req_in[REQ_W - 1 - 32*(16 + i) -: 32] = state_in[i];
+end
+
+always_ff @(posedge clk or posedge wb_rst_i) begin
+	if (wb_rst_i) begin
+		sent <= 1'b0;
+		done <= 1'b0;
+		foreach (state_out[i]) state_out[i] <= 32'h0;
+	end else begin
+		done <= res_pop;
+		if (req_push)
+			sent <= 1'b1;
+		else if (done)              // The register file moves to the next bank on done
+			sent <= 1'b0;
+		if (res_pop)
+			for (int i = 0; i < 8; i++)
+				state_out[i] <= res_out[RES_W - 1 - 32*i -: 32];
+	end
+end
+
+logic [2:0]	core_fsm;
+logic [2:0]	fsm_hold;               // core_clk: sample, stable while req != ack
+logic		fsm_req, fsm_ack;
+(* ASYNC_REG = "TRUE" *) logic [1:0]	fsm_req_s;  // req in clk
+(* ASYNC_REG = "TRUE" *) logic [1:0]	fsm_ack_s;  // ack in core_clk
+
+always_ff @(posedge clk or posedge wb_rst_i)
+	if (wb_rst_i) begin
+		fsm_req_s <= 2'b00;
+		fsm_ack   <= 1'b0;
+		fsm_state <= 3'd0;
+	end else begin
+		fsm_req_s <= {fsm_req_s[0], fsm_req};
+		if (fsm_req_s[1] != fsm_ack) begin  // New sample: fsm_hold has been stable for two clk
+			fsm_state <= fsm_hold;
+			fsm_ack   <= fsm_req_s[1];
+		end
+	end
+
+always_ff @(posedge core_clk or posedge core_rst)
+	if (core_rst) begin
+		fsm_ack_s <= 2'b00;
+		fsm_req   <= 1'b0;
+		fsm_hold  <= 3'd0;
+	end else begin
+		fsm_ack_s <= {fsm_ack_s[0], fsm_ack};
+		if (fsm_req == fsm_ack_s[1]) begin  // Previous sample taken: capture the next one
+			fsm_hold <= core_fsm;
+			fsm_req  <= ~fsm_req;
+		end
+	end
+
+// ----------------------------------
+// Crossings
+// ----------------------------------
+logic	[REQ_W-1:0]		req_out;
+logic					req_empty;
+logic	[RES_W-1:0]		res_in;
+logic					core_done;
+
+accelerator_async_fifo #(
+	.WIDTH	(REQ_W),
+	.DEPTH	(DEPTH)
+) req_fifo (
+	.wr_clk		(clk),
+	.wr_rst		(wb_rst_i),
+	.wr_en		(req_push),
+	.wr_data	(req_in),
+	.full		(req_full),
+	.rd_clk		(core_clk),
+	.rd_rst		(core_rst),
+	.rd_en		(core_done),        // Released once the core has read state_in in DONE
+	.rd_data	(req_out),
+	.empty		(req_empty)
+);
+
+accelerator_async_fifo #(
+	.WIDTH	(RES_W),
+	.DEPTH	(DEPTH)
+) res_fifo (
+	.wr_clk		(core_clk),
+	.wr_rst		(core_rst),
+	.wr_en		(core_done),
+	.wr_data	(res_in),
+	.full		(),                 // Never full: one block in flight
+	.rd_clk		(clk),
+	.rd_rst		(wb_rst_i),
+	.rd_en		(res_pop),
+	.rd_data	(res_out),
+	.empty		(res_empty)
+);
+
+// ----------------------------------
+// Core side
+// ----------------------------------
+logic	[31:0]	core_msg  [0:15];
+logic	[31:0]	core_in   [0:7];
+logic	[31:0]	core_out  [0:7];
+
+always_comb begin
+	for (int i = 0; i < 16; i++)
+		core_msg[i] = req_out[REQ_W - 1 - 32*i -: 32];
+	for (int i = 0; i < 8; i++) begin
+		core_in[i] = req_out[REQ_W - 1 - 32*(16 + i) -: 32];
+		res_in[RES_W - 1 - 32*i -: 32] = core_out[i];
+	end
+end
+
+accelerator #(
+	.ONLINE_SCHEDULE	(ONLINE_SCHEDULE),
+	.ROUNDS_PER_CYCLE	(ROUNDS_PER_CYCLE),
+	.SHARED_K			(SHARED_K),
+	.CLOCK_GATE			(CLOCK_GATE)
+) core (
+	.clk		(core_clk),
+	.wb_rst_i	(core_rst),
+	.enable		(core_en_s[1]),
+	.control	({31'b0, !req_empty}),
+	.done		(core_done),
+	.overflow	(overflow),
+	.msg_word	(core_msg),
+	.state_in	(core_in),
+	.state_out	(core_out),
+	.fsm_state	(core_fsm),
+	.k_addr		(k_addr),
+	.k_word		(k_word)
+);
+
+endmodule
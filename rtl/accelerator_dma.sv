@@ -0,0 +1,288 @@
+// =====================================
+// SHA256 DMA Engine
+// - Wishbone master that streams a message from system memory into one
+//   accelerator core, 64 bytes at a time, and writes the 32-byte digest back
+// - Drives the core through the register file (internal register master
+//   port), so it uses the same banks, CONTINUE chaining and DONE handshake
+//   as software does
+// - Queues the last block with FINAL | AUTO_LEN, so the register file pads
+//   it (accelerator_pad) from its own block count and adds the length block
+//   when needed
+// - Programming: DMA_SRC, DMA_LEN, then DMA_DST (writing DMA_DST starts the job)
+// - SRC and DST must be 4-byte aligned; memory is little-endian, so message
+//   words are byte-swapped on the way in and digest words on the way out
+// - A start naming a core that is not built ends at once with the core
+//   error bit set (and done_o), instead of waiting for a DONE that never comes
+// =====================================
+module accelerator_dma #(
+	parameter NUM_CORES = 2
+) (
+	input	logic			clk,
+	input	logic			wb_rst_i,
+
+	// Register slave (DMA block of the global window)
+	input	logic			reg_sel,       // Access targets the DMA block
+	input	logic	[8:0]	reg_addr,      // Offset inside the block
+	input	logic	[31:0]	reg_dat_i,
+	output	logic	[31:0]	reg_dat_o,
+	input	logic			reg_we,
+
+	// Register master into accelerator_regs
+	output	logic			rm_req,        // Access requested (held until rm_gnt)
+	output	logic			rm_we,
+	output	logic	[13:0]	rm_addr,
+	output	logic	[31:0]	rm_wdata,
+	input	logic			rm_gnt,        // Access performed this cycle
+	input	logic	[31:0]	rm_rdata,      // Read data, valid with rm_gnt
+
+	// WISHBONE master (classic cycles)
+	output	logic			wbm_cyc_o,
+	output	logic			wbm_stb_o,
+	output	logic			wbm_we_o,
+	output	logic	[31:0]	wbm_adr_o,
+	output	logic	[31:0]	wbm_dat_o,
+	output	logic	[3:0]	wbm_sel_o,
+	output	logic	[2:0]	wbm_cti_o,
+	output	logic	[1:0]	wbm_bte_o,
+	input	logic	[31:0]	wbm_dat_i,
+	input	logic			wbm_ack_i,
+	input	logic			wbm_err_i,
+
+	output	logic			done_o         // One-cycle pulse when a job finishes (also on a bus error)
+);
+
+// ----------------------------------
+// Constants
+// ----------------------------------
+localparam REG_DMA_CONTROL = 9'h00;  // W: [11:8] core. R: bit 0 busy, bit 29 core error, bit 30 bus error, bit 31 done
+localparam REG_DMA_SRC     = 9'h04;  // Source byte address
+localparam REG_DMA_LEN     = 9'h08;  // Message length in bytes
+localparam REG_DMA_DST     = 9'h0C;  // Digest destination byte address (write starts the job)
+
+// Core window offsets (see accelerator_regs)
+localparam REG_CONTROL     = 9'h00;
+localparam REG_MSG_BASE    = 9'h04;
+localparam REG_STATE_IN    = 9'h44;
+localparam REG_STATE_OUT   = 9'h64;
+localparam REG_STATUS      = 9'h84;
+
+localparam CTRL_GO         = 32'h0000_0001;
+localparam CTRL_CONTINUE   = 32'h0000_0002;
+localparam CTRL_FINAL      = 32'h0000_0004;
+localparam CTRL_AUTO_LEN   = 32'h0000_0040;
+localparam CTRL_BUSY_BIT   = 0;
+localparam CTRL_DONE_BIT   = 31;
+localparam STATUS_FULL_BIT = 1;
+
+localparam logic [31:0] SHA256_IV [0:7] = '{
+	32'h6a09e667, 32'hbb67ae85, 32'h3c6ef372, 32'ha54ff53a,
+	32'h510e527f, 32'h9b05688c, 32'h1f83d9ab, 32'h5be0cd19
+};
+
+function logic [31:0] BSWAP(input logic [31:0] x);
+	return {x[7:0], x[15:8], x[23:16], x[31:24]};
+endfunction
+
+// ----------------------------------
+// Registers
+// ----------------------------------
+logic [3:0]		cfg_core;
+logic [31:0]	src, len, dst;
+logic			busy, done_flag, bus_err, core_err;
+
+typedef enum logic [3:0] {
+	IDLE,       // Waiting for DMA_DST write
+	CHECK,      // Wait for the core's fill bank to be free
+	FETCH,      // Read one message word from memory
+	PUSH,       // Write the word into the fill bank
+	STATE_IV,   // First block: write the initial hash state
+	KICK,       // Queue the block (GO, CONTINUE, FINAL | AUTO_LEN)
+	WAIT_DONE,  // Wait for the last block to finish
+	READ_OUT,   // Read one state_out word
+	STORE       // Write one digest word to memory
+} dma_state_t;
+dma_state_t state;
+
+logic [26:0]	blk;        // Current block
+logic [26:0]	nblk;       // Full blocks plus the FINAL block
+logic [3:0]		word;       // Word inside block / state index
+logic [31:0]	data;       // Word being moved
+
+wire [31:0]	byte_off = {blk[25:0], word, 2'b00};          // Offset of the current word in the message
+wire		last_blk = (blk == nblk - 1'b1);
+wire		more_msg = (byte_off + 3'd4 < len);               // Next word holds message bytes
+wire [13:0]	core_base = {1'b0, cfg_core, 9'h000};
+wire		start     = reg_sel && reg_we && !busy && (reg_addr == REG_DMA_DST);
+wire		bad_core  = (cfg_core >= NUM_CORES);
+
+// Control word that queues the current block
+wire [31:0]	kick_ctrl = CTRL_GO
+                      | ((blk != 0) ? CTRL_CONTINUE : 32'h0)
+                      | (last_blk ? (CTRL_FINAL | CTRL_AUTO_LEN | {18'b0, len[5:0], 8'b0}) : 32'h0);
+
+assign done_o = ((state == STORE) && wbm_ack_i && (word == 4'd7))
+              || ((state == FETCH || state == STORE) && wbm_err_i)
+              || (start && bad_core);
+
+// ----------------------------------
+// Register slave
+// ----------------------------------
+always_comb begin
+	reg_dat_o = 32'h0;
+	case (reg_addr)
+		REG_DMA_CONTROL: reg_dat_o = {done_flag, bus_err, core_err, 17'b0, cfg_core, 7'b0, busy};
+		REG_DMA_SRC:     reg_dat_o = src;
+		REG_DMA_LEN:     reg_dat_o = len;
+		REG_DMA_DST:     reg_dat_o = dst;
+	endcase
+end
+
+// ----------------------------------
+// Register master / Wishbone master request decode
+// ----------------------------------
+always_comb begin
+	rm_req   = 1'b0;
+	rm_we    = 1'b0;
+	rm_addr  = core_base;
+	rm_wdata = 32'h0;
+
+	case (state)
+		CHECK:     begin rm_req = 1'b1; rm_addr = core_base + REG_STATUS; end
+		PUSH:      begin rm_req = 1'b1; rm_we = 1'b1; rm_addr = core_base + REG_MSG_BASE + {word, 2'b00}; rm_wdata = data; end
+		STATE_IV:  begin rm_req = 1'b1; rm_we = 1'b1; rm_addr = core_base + REG_STATE_IN + {word, 2'b00}; rm_wdata = SHA256_IV[word[2:0]]; end
+		KICK:      begin rm_req = 1'b1; rm_we = 1'b1; rm_addr = core_base + REG_CONTROL; rm_wdata = kick_ctrl; end
+		WAIT_DONE: begin rm_req = 1'b1; rm_addr = core_base + REG_CONTROL; end
+		READ_OUT:  begin rm_req = 1'b1; rm_addr = core_base + REG_STATE_OUT + {word, 2'b00}; end
+		default: ;
+	endcase
+end
+
+assign wbm_cyc_o = (state == FETCH) || (state == STORE);
+assign wbm_stb_o = wbm_cyc_o;
+assign wbm_we_o  = (state == STORE);
+assign wbm_adr_o = (state == STORE) ? (dst + {word, 2'b00}) : (src + byte_off);
+assign wbm_dat_o = data;
+assign wbm_sel_o = 4'hf;
+assign wbm_cti_o = 3'b000;   // Classic cycles
+assign wbm_bte_o = 2'b00;
+
+// ----------------------------------
+// DMA FSM
+// ----------------------------------
+always_ff @(posedge clk or posedge wb_rst_i) begin
+	if (wb_rst_i) begin
+		cfg_core  <= 4'd0;
+		src       <= 32'h0;
+		len       <= 32'h0;
+		dst       <= 32'h0;
+		busy      <= 1'b0;
+		done_flag <= 1'b0;
+		bus_err   <= 1'b0;
+		core_err  <= 1'b0;
+		state     <= IDLE;
+		blk       <= 0;
+		nblk      <= 0;
+		word      <= 0;
+		data      <= 32'h0;
+	end else begin
+		// ----------- REGISTER WRITES (ignored while busy) ------------
+		if (reg_sel && reg_we && !busy) begin
+			case (reg_addr)
+				REG_DMA_CONTROL: cfg_core <= reg_dat_i[11:8];
+				REG_DMA_SRC:     src <= {reg_dat_i[31:2], 2'b00};
+				REG_DMA_LEN:     len <= reg_dat_i;
+				REG_DMA_DST: begin
+					dst       <= {reg_dat_i[31:2], 2'b00};
+					nblk      <= 27'(len >> 6) + 1'b1;          // The FINAL block may hold 0 bytes
+					blk       <= 0;
+					word      <= 0;
+					done_flag <= 1'b0;
+					bus_err   <= 1'b0;
+					core_err  <= bad_core;
+					if (!bad_core) begin                       // No such core: refuse the job
+						busy  <= 1'b1;
+						state <= CHECK;
+					end
+				end
+			endcase
+		end
+
+		case (state)
+			IDLE: ;
+
+			// Only words holding message bytes are moved; FINAL pads the rest
+			CHECK: if (rm_gnt && !rm_rdata[STATUS_FULL_BIT]) begin
+				word <= 0;
+				if (byte_off < len)
+					state <= FETCH;
+				else
+					state <= (blk == 0) ? STATE_IV : KICK;         // Empty FINAL block
+			end
+
+			FETCH: if (wbm_err_i) begin
+				bus_err <= 1'b1;
+				busy    <= 1'b0;
+				state   <= IDLE;
+			end else if (wbm_ack_i) begin
+				data  <= BSWAP(wbm_dat_i);     // SHA256 words are big-endian
+				state <= PUSH;
+			end
+
+			PUSH: if (rm_gnt) begin
+				if (word == 4'd15 || !more_msg) begin
+					word  <= 0;
+					state <= (blk == 0) ? STATE_IV : KICK;
+				end else begin
+					word  <= word + 1'b1;
+					state <= FETCH;
+				end
+			end
+
+			STATE_IV: if (rm_gnt) begin
+				if (word == 4'd7) begin
+					word  <= 0;
+					state <= KICK;
+				end else
+					word <= word + 1'b1;
+			end
+
+			KICK: if (rm_gnt) begin
+				if (last_blk)
+					state <= WAIT_DONE;
+				else begin
+					blk   <= blk + 1'b1;
+					state <= CHECK;
+				end
+			end
+
+			WAIT_DONE: if (rm_gnt && rm_rdata[CTRL_DONE_BIT] && !rm_rdata[CTRL_BUSY_BIT]) begin
+				word  <= 0;
+				state <= READ_OUT;
+			end
+
+			READ_OUT: if (rm_gnt) begin
+				data  <= BSWAP(rm_rdata);      // Digest bytes in memory order
+				state <= STORE;
+			end
+
+			STORE: if (wbm_err_i) begin
+				bus_err <= 1'b1;
+				busy    <= 1'b0;
+				state   <= IDLE;
+			end else if (wbm_ack_i) begin
+				if (word == 4'd7) begin
+					busy      <= 1'b0;
+					done_flag <= 1'b1;
+					state     <= IDLE;
+				end else begin
+					word  <= word + 1'b1;
+					state <= READ_OUT;
+				end
+			end
+
+			default: state <= IDLE;
+		endcase
+	end
+end
+
+endmodule
@@ -0,0 +1,55 @@
+// =====================================
+// Synchronous FIFO
+// - First-word-fall-through: rd_data shows the head entry while !empty
+// - Storage has no reset and a single write port, so it maps to LUTRAM
+// - DEPTH must be a power of two
+// =====================================
+module accelerator_fifo #(
+	parameter WIDTH = 32,
+	parameter DEPTH = 16
+) (
+	input	logic					clk,
+	input	logic					wb_rst_i,
+
+	input	logic					wr_en,      // Push wr_data (ignored when full)
+	input	logic	[WIDTH-1:0]		wr_data,
+	input	logic					rd_en,      // Pop the head entry (ignored when empty)
+	output	logic	[WIDTH-1:0]		rd_data,
+
+	output	logic					full,
+	output	logic					empty,
+	output	logic	[$clog2(DEPTH):0]	count
+);
+
+localparam AW = $clog2(DEPTH);
+
+if (DEPTH < 2 || (1 << AW) != DEPTH)
+	$error("accelerator_fifo: DEPTH must be a power of two >= 2");
+
+(* ram_style = "distributed" *)
+logic [WIDTH-1:0]	mem [0:DEPTH-1];
+logic [AW:0]		wr_ptr, rd_ptr;   // One extra bit tells full from empty
+
+wire push = wr_en && !full;
+wire pop  = rd_en && !empty;
+
+assign empty   = (wr_ptr == rd_ptr);
+assign full    = (wr_ptr[AW-1:0] == rd_ptr[AW-1:0]) && (wr_ptr[AW] != rd_ptr[AW]);
+assign count   = wr_ptr - rd_ptr;
+assign rd_data = mem[rd_ptr[AW-1:0]];
+
+always_ff @(posedge clk)
+	if (push)
+		mem[wr_ptr[AW-1:0]] <= wr_data;
+
+always_ff @(posedge clk or posedge wb_rst_i) begin
+	if (wb_rst_i) begin
+		wr_ptr <= 0;
+		rd_ptr <= 0;
+	end else begin
+		if (push) wr_ptr <= wr_ptr + 1'b1;
+		if (pop)  rd_ptr <= rd_ptr + 1'b1;
+	end
+end
+
+endmodule
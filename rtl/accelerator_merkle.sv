@@ -0,0 +1,417 @@
+// =====================================
+// SHA256 Merkle Tree Engine
+// - Reduces COUNT 32-byte leaf digests to the Merkle root: every internal
+//   node is SHA256(left || right), one 64-byte block plus the constant
+//   padding block
+// - Leaves sit in a block RAM node buffer, written over the bus (LEAF_DATA)
+//   or fetched from memory by the built-in Wishbone master (LOAD)
+// - Each level is reduced in place: LANES dedicated cores hash LANES pairs
+//   per pass, and node i of the next level overwrites node i
+// - An odd node at the end of a level is hashed with itself (DUP_ODD, the
+//   Bitcoin rule) or promoted unchanged to the next level
+// - While reducing, the sibling of leaf INDEX is captured at every level,
+//   so the authentication path is ready with the root
+// - Offset bit 8 selects the little-endian view: LEAF_DATA writes and
+//   ROOT/PATH reads are byte-swapped, like the core windows
+// =====================================
+module accelerator_merkle #(
+	parameter LANES = 1,              // Cores hashing pairs in parallel (1-8)
+	parameter ONLINE_SCHEDULE = 1,
+	parameter ROUNDS_PER_CYCLE = 1,
+	parameter MAX_LEAVES = 1024       // Node buffer size in leaves (power of two, 2-65536)
+) (
+	input	logic			clk,
+	input	logic			wb_rst_i,
+
+	// Register slave (Merkle block of the global window)
+	input	logic			reg_sel,
+	input	logic	[8:0]	reg_addr,
+	input	logic	[31:0]	reg_dat_i,
+	output	logic	[31:0]	reg_dat_o,
+	input	logic			reg_we,
+
+	// WISHBONE master for leaf loading (classic read cycles)
+	output	logic			wbm_cyc_o,
+	output	logic			wbm_stb_o,
+	output	logic			wbm_we_o,
+	output	logic	[31:0]	wbm_adr_o,
+	output	logic	[31:0]	wbm_dat_o,
+	output	logic	[3:0]	wbm_sel_o,
+	output	logic	[2:0]	wbm_cti_o,
+	output	logic	[1:0]	wbm_bte_o,
+	input	logic	[31:0]	wbm_dat_i,
+	input	logic			wbm_ack_i,
+	input	logic			wbm_err_i,
+
+	output	logic			done_o     // One-cycle pulse when the root is ready (or a fetch failed)
+);
+
+// ----------------------------------
+// Constants
+// ----------------------------------
+localparam REG_MERKLE_CONTROL = 8'h00;  // W: see *_BIT below. R: status
+localparam REG_COUNT          = 8'h04;  // Number of leaves (1-MAX_LEAVES)
+localparam REG_INDEX          = 8'h08;  // Leaf whose authentication path is captured
+localparam REG_SRC            = 8'h0C;  // LOAD: leaf buffer byte address (4-byte aligned)
+localparam REG_LEAF_PTR       = 8'h10;  // Node buffer word pointer for LEAF_DATA
+localparam REG_LEAF_DATA      = 8'h14;  // W: store a leaf word at LEAF_PTR, then LEAF_PTR += 1
+localparam REG_PATH_LEVEL     = 8'h18;  // Path entry shown at 0x44-0x60
+localparam REG_PATH_VALID     = 8'h1C;  // R: bit L = level L has a sibling (0 = promoted)
+localparam REG_ROOT           = 8'h24;  // 0x24-0x40: root (big-endian words)
+localparam REG_PATH           = 8'h44;  // 0x44-0x60: sibling at PATH_LEVEL
+
+localparam START_BIT    = 0;   // W: reduce the leaves in the node buffer (ignored while busy)
+localparam LOAD_BIT     = 1;   // W: with START, fetch COUNT leaves from SRC first
+localparam DUP_ODD_BIT  = 2;   // Config: hash an odd last node with itself
+// R: bit 0 busy, bit 2 dup_odd, bits [20:16] depth, bit 30 bus error, bit 31 done
+
+localparam LW = $clog2(MAX_LEAVES);       // Node index width
+localparam FW = $clog2(LANES * 16);       // Fetch / write-back counter width
+
+localparam logic [31:0] SHA256_IV [0:7] = '{
+	32'h6a09e667, 32'hbb67ae85, 32'h3c6ef372, 32'ha54ff53a,
+	32'h510e527f, 32'h9b05688c, 32'h1f83d9ab, 32'h5be0cd19
+};
+
+if (LANES < 1 || LANES > 8)
+	$error("accelerator_merkle: LANES must be between 1 and 8");
+if (MAX_LEAVES < 2 || MAX_LEAVES > 65536 || (1 << LW) != MAX_LEAVES)
+	$error("accelerator_merkle: MAX_LEAVES must be a power of two between 2 and 65536");
+
+function logic [31:0] BSWAP(input logic [31:0] x);
+	return {x[7:0], x[15:8], x[23:16], x[31:24]};
+endfunction
+
+// ----------------------------------
+// Registers
+// ----------------------------------
+logic [LW:0]	cfg_count;
+logic [LW-1:0]	cfg_index;
+logic [31:0]	src;
+logic [LW+2:0]	leaf_ptr;
+logic [4:0]		path_level;
+logic			cfg_dup;
+
+logic			busy, done_flag, bus_err;
+logic [4:0]		depth;
+
+logic [31:0]	root [0:7];
+logic [31:0]	path [0:LW-1][0:7];
+logic [LW-1:0]	path_valid;
+
+typedef enum logic [2:0] {
+	IDLE,       // Waiting for START
+	LOAD,       // Fetch one leaf word from memory
+	FETCH,      // Read the pairs of this pass from the node buffer
+	RUN1,       // Lanes hash left || right
+	RUN2,       // Lanes hash the padding block
+	WB,         // Write the parent nodes back
+	NEXT        // Next pass, next level or finish
+} merkle_state_t;
+merkle_state_t state;
+
+logic [LW:0]	n;          // Nodes in the current level
+logic [LW-1:0]	pbase;      // First pair of the current pass
+logic [4:0]		level;
+logic [LW-1:0]	idx;        // Position of leaf INDEX in the current level
+logic [LW+2:0]	load_w;     // LOAD: next leaf word
+logic [FW:0]	f, w;       // FETCH issue / write-back counters
+logic [FW:0]	f_d;        // FETCH word whose data is in mem_q
+logic			f_v;
+logic [LW-1:0]	node_d;     // Node of that word
+
+wire [LW:0]		npairs  = (n + 1'b1) >> 1;                 // Nodes in the next level
+wire [LW:0]		left    = npairs - pbase;
+wire [FW:0]		nl      = (left < LANES) ? left[FW:0] : (FW+1)'(LANES);  // Lanes used this pass
+wire [LW-1:0]	sib     = idx ^ 1'b1;
+wire			sib_in  = ({1'b0, sib} < n);
+wire [LW-1:0]	sib_node = sib_in ? sib : idx;             // Duplicated node is its own sibling
+
+// FETCH: word f is word f[2:0] of the left (f[3] = 0) or right child of pair pbase + f / 16
+wire [LW:0]		f_pair  = pbase + (f >> 4);
+wire [LW+1:0]	f_raw   = {f_pair, f[3]};
+wire [LW-1:0]	f_node  = (f_raw >= n) ? LW'(n - 1'b1) : f_raw[LW-1:0];  // Odd end: left child again
+
+// WB: word w is word w[2:0] of parent pbase + w / 8
+wire [2:0]		wb_lane = 3'(w >> 3);
+wire [LW:0]		wb_node = pbase + wb_lane;
+wire			wb_promote = ({wb_node, 1'b1} >= n) && (!cfg_dup || n == 1);
+
+// ----------------------------------
+// Lanes
+// ----------------------------------
+logic [31:0]		lane_blk [0:LANES-1][0:15];   // left || right
+logic [31:0]		lane_mid [0:LANES-1][0:7];    // State after left || right, then the parent
+logic [31:0]		lane_msg   [0:LANES-1][0:15];
+logic [31:0]		lane_state [0:LANES-1][0:7];
+logic [31:0]		lane_out   [0:LANES-1][0:7];
+logic [LANES-1:0]	lane_done;
+wire  [31:0]		lane_ctrl = {31'b0, (state == RUN1) || (state == RUN2)};
+
+// Both inputs only change on a pass boundary, so they are stable from LOAD
+// to DONE inside the cores
+always_comb begin
+	for (int j = 0; j < LANES; j++) begin
+		for (int i = 0; i < 16; i++)
+			if (state == RUN2)
+				lane_msg[j][i] = (i == 0) ? 32'h8000_0000 : (i == 15) ? 32'd512 : 32'h0;
+			else
+				lane_msg[j][i] = lane_blk[j][i];
+		lane_state[j] = (state == RUN2) ? lane_mid[j] : SHA256_IV;
+	end
+end
+
+// The lanes start together and run in lockstep, so one K ROM port serves all
+// of them (lane 0 drives the address)
+logic [5:0]		lane_k_addr [0:LANES-1];
+logic [31:0]	lane_k [0:0][0:ROUNDS_PER_CYCLE-1];
+
+accelerator_krom #(
+	.PORTS				(1),
+	.ROUNDS_PER_CYCLE	(ROUNDS_PER_CYCLE),
+	.ROM_STYLE			("distributed")
+) krom (
+	.clk		(clk),
+	.addr		(lane_k_addr[0:0]),
+	.k_word		(lane_k)
+);
+
+for (genvar j = 0; j < LANES; j++) begin : g_lane
+	accelerator #(
+		.ONLINE_SCHEDULE	(ONLINE_SCHEDULE),
+		.ROUNDS_PER_CYCLE	(ROUNDS_PER_CYCLE),
+		.SHARED_K			(1)
+	) accelerator (
+		.clk		(clk),
+		.wb_rst_i	(wb_rst_i),
+		.enable		(1'b1),              // Gates itself while idle
+		.control	(lane_ctrl),
+		.done		(lane_done[j]),
+		.overflow	(),
+		.msg_word	(lane_msg[j]),
+		.state_in	(lane_state[j]),
+		.state_out	(lane_out[j]),
+		.fsm_state	(),
+		.k_addr		(lane_k_addr[j]),
+		.k_word		(lane_k[0])
+	);
+end
+
+// ----------------------------------
+// Node buffer
+// ----------------------------------
+// Single write port (leaf load or write-back), single registered read port
+(* ram_style = "block" *)
+logic [31:0]	mem [0:MAX_LEAVES*8-1];
+logic [31:0]	mem_q;
+logic			mem_we;
+logic [LW+2:0]	mem_waddr;
+logic [31:0]	mem_wdata;
+
+wire le_view   = reg_addr[8];
+wire leaf_wr   = reg_sel && reg_we && !busy && (reg_addr[7:0] == REG_LEAF_DATA);
+
+always_comb begin
+	mem_we    = 1'b0;
+	mem_waddr = leaf_ptr;
+	mem_wdata = le_view ? BSWAP(reg_dat_i) : reg_dat_i;
+	if (state == LOAD) begin
+		mem_we    = wbm_ack_i;
+		mem_waddr = load_w;
+		mem_wdata = BSWAP(wbm_dat_i);       // Memory holds digest bytes in order
+	end else if (state == WB) begin
+		mem_we    = 1'b1;
+		mem_waddr = {wb_node[LW-1:0], w[2:0]};
+		mem_wdata = wb_promote ? lane_blk[wb_lane][w[2:0]] : lane_mid[wb_lane][w[2:0]];
+	end else
+		mem_we    = leaf_wr;
+end
+
+always_ff @(posedge clk) begin
+	if (mem_we)
+		mem[mem_waddr] <= mem_wdata;
+	mem_q <= mem[{f_node, f[2:0]}];
+end
+
+// ----------------------------------
+// Leaf loader (Wishbone master)
+// ----------------------------------
+assign wbm_cyc_o = (state == LOAD);
+assign wbm_stb_o = wbm_cyc_o;
+assign wbm_we_o  = 1'b0;
+assign wbm_adr_o = src + {load_w, 2'b00};
+assign wbm_dat_o = 32'h0;
+assign wbm_sel_o = 4'hf;
+assign wbm_cti_o = 3'b000;   // Classic cycles
+assign wbm_bte_o = 2'b00;
+
+assign done_o = ((state == NEXT) && (pbase + nl >= npairs) && (npairs == 1))
+              || ((state == LOAD) && wbm_err_i);
+
+// ----------------------------------
+// Register slave
+// ----------------------------------
+always_comb begin
+	reg_dat_o = 32'h0;
+	case (reg_addr[7:0])
+		REG_MERKLE_CONTROL: reg_dat_o = {done_flag, bus_err, 9'b0, depth, 13'b0, cfg_dup, 1'b0, busy};
+		REG_COUNT:          reg_dat_o = 32'(cfg_count);
+		REG_INDEX:          reg_dat_o = 32'(cfg_index);
+		REG_SRC:            reg_dat_o = src;
+		REG_LEAF_PTR:       reg_dat_o = 32'(leaf_ptr);
+		REG_PATH_LEVEL:     reg_dat_o = 32'(path_level);
+		REG_PATH_VALID:     reg_dat_o = 32'(path_valid);
+
+		8'h24,8'h28,8'h2C,8'h30,8'h34,8'h38,8'h3C,8'h40:
+			reg_dat_o = le_view ? BSWAP(root[(reg_addr[7:0] - REG_ROOT) >> 2])
+			                    : root[(reg_addr[7:0] - REG_ROOT) >> 2];
+
+		8'h44,8'h48,8'h4C,8'h50,8'h54,8'h58,8'h5C,8'h60:
+			if (path_level < LW)
+				reg_dat_o = le_view ? BSWAP(path[path_level][(reg_addr[7:0] - REG_PATH) >> 2])
+				                    : path[path_level][(reg_addr[7:0] - REG_PATH) >> 2];
+	endcase
+end
+
+// ----------------------------------
+// Reduction FSM
+// ----------------------------------
+always_ff @(posedge clk or posedge wb_rst_i) begin
+	if (wb_rst_i) begin
+		cfg_count  <= 0;
+		cfg_index  <= 0;
+		src        <= 32'h0;
+		leaf_ptr   <= 0;
+		path_level <= 5'd0;
+		cfg_dup    <= 1'b0;
+		busy       <= 1'b0;
+		done_flag  <= 1'b0;
+		bus_err    <= 1'b0;
+		depth      <= 5'd0;
+		foreach (root[i]) root[i] <= 0;
+		foreach (path[i,j]) path[i][j] <= 0;
+		path_valid <= 0;
+		foreach (lane_blk[i,j]) lane_blk[i][j] <= 0;
+		foreach (lane_mid[i,j]) lane_mid[i][j] <= 0;
+		state      <= IDLE;
+		n          <= 0;
+		pbase      <= 0;
+		level      <= 5'd0;
+		idx        <= 0;
+		load_w     <= 0;
+		f          <= 0;
+		w          <= 0;
+		f_d        <= 0;
+		f_v        <= 1'b0;
+		node_d     <= 0;
+	end else begin
+		// ----------- REGISTER WRITES (ignored while busy) ------------
+		if (reg_sel && reg_we && !busy) begin
+			case (reg_addr[7:0])
+				REG_MERKLE_CONTROL: begin
+					cfg_dup <= reg_dat_i[DUP_ODD_BIT];
+					if (reg_dat_i[START_BIT] && cfg_count != 0 && cfg_count <= MAX_LEAVES) begin
+						n          <= cfg_count;
+						pbase      <= 0;
+						level      <= 5'd0;
+						idx        <= cfg_index;
+						path_valid <= 0;
+						load_w     <= 0;
+						f          <= 0;
+						f_v        <= 1'b0;
+						busy       <= 1'b1;
+						done_flag  <= 1'b0;
+						bus_err    <= 1'b0;
+						state      <= reg_dat_i[LOAD_BIT] ? LOAD : FETCH;
+					end
+				end
+				REG_COUNT:      cfg_count  <= reg_dat_i[LW:0];
+				REG_INDEX:      cfg_index  <= reg_dat_i[LW-1:0];
+				REG_SRC:        src        <= {reg_dat_i[31:2], 2'b00};
+				REG_LEAF_PTR:   leaf_ptr   <= reg_dat_i[LW+2:0];
+				REG_LEAF_DATA:  leaf_ptr   <= leaf_ptr + 1'b1;
+				REG_PATH_LEVEL: path_level <= reg_dat_i[4:0];
+			endcase
+		end
+
+		case (state)
+			IDLE: ;
+
+			LOAD: if (wbm_err_i) begin
+				bus_err <= 1'b1;
+				busy    <= 1'b0;
+				state   <= IDLE;
+			end else if (wbm_ack_i) begin
+				load_w <= load_w + 1'b1;
+				if (load_w == (LW+3)'({cfg_count, 3'b000} - 1'b1))   // Last word of the last leaf
+					state <= FETCH;
+			end
+
+			// One read issued per cycle; data arrives one cycle later
+			FETCH: begin
+				f_v    <= (f < nl * 16);
+				f_d    <= f;
+				node_d <= f_node;
+				if (f < nl * 16)
+					f <= f + 1'b1;
+				if (f_v) begin
+					lane_blk[f_d >> 4][f_d[3:0]] <= mem_q;
+					if (node_d == sib_node)
+						path[level][f_d[2:0]] <= mem_q;
+				end
+				if (f_v && f_d == nl * 16 - 1'b1) begin
+					f_v   <= 1'b0;
+					state <= RUN1;
+				end
+			end
+
+			// All lanes start together and take the same number of cycles
+			RUN1: if (lane_done[0]) begin
+				lane_mid <= lane_out;
+				state    <= RUN2;
+			end
+
+			RUN2: if (lane_done[0]) begin
+				lane_mid <= lane_out;
+				w        <= 0;
+				state    <= WB;
+			end
+
+			WB: begin
+				if (wb_node == 0)
+					root[w[2:0]] <= mem_wdata;
+				if (w == nl * 8 - 1'b1)
+					state <= NEXT;
+				else
+					w <= w + 1'b1;
+			end
+
+			NEXT: begin
+				f <= 0;
+				if (pbase + nl < npairs) begin
+					pbase <= pbase + nl;
+					state <= FETCH;
+				end else begin
+					if (n != 1)
+						path_valid[level] <= sib_in || cfg_dup;
+					if (npairs == 1) begin
+						depth     <= (n == 1) ? 5'd0 : level + 1'b1;
+						busy      <= 1'b0;
+						done_flag <= 1'b1;
+						state     <= IDLE;
+					end else begin
+						n     <= npairs;
+						pbase <= 0;
+						idx   <= idx >> 1;
+						level <= level + 1'b1;
+						state <= FETCH;
+					end
+				end
+			end
+
+			default: state <= IDLE;
+		endcase
+	end
+end
+
+endmodule
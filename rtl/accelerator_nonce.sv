@@ -0,0 +1,329 @@
+// =====================================
+// SHA256 Nonce Sweep Engine
+// - For fixed-prefix searches: software loads the midstate (state after the
+//   common prefix blocks), a template for the last block, a nonce word index,
+//   a nonce range and a 256-bit target, then starts the sweep
+// - LANES dedicated cores each hash one nonce per pass (nonce, nonce + 1, ...),
+//   optionally followed by a second pass over the 32-byte digest (SHA256d)
+// - A digest <= target pushes its nonce into the FOUND FIFO; nothing else
+//   crosses the bus until the range is exhausted or STOP is written
+// - CMP_LE compares the digest as a little-endian number and NONCE_LE stores
+//   the nonce little-endian in its word, which is the Bitcoin header layout
+// =====================================
+module accelerator_nonce #(
+	parameter LANES = 1,              // Cores sweeping in parallel (1-8)
+	parameter ONLINE_SCHEDULE = 1,
+	parameter ROUNDS_PER_CYCLE = 1,
+	parameter FOUND_DEPTH = 16        // Matching nonces buffered for software
+) (
+	input	logic			clk,
+	input	logic			wb_rst_i,
+
+	// Register slave (nonce block of the global window)
+	input	logic			reg_sel,
+	input	logic	[8:0]	reg_addr,
+	input	logic	[31:0]	reg_dat_i,
+	output	logic	[31:0]	reg_dat_o,
+	input	logic			reg_we,
+
+	output	logic			done_o     // One-cycle pulse when a sweep ends
+);
+
+// ----------------------------------
+// Constants
+// ----------------------------------
+localparam REG_NONCE_CONTROL = 9'h00;  // W: see *_BIT below. R: status
+localparam REG_TEMPLATE      = 9'h04;  // 0x04-0x40: last block template (big-endian words)
+localparam REG_MIDSTATE      = 9'h44;  // 0x44-0x60: state_in of the last block
+localparam REG_TARGET        = 9'h64;  // 0x64-0x80: target, word 0 most significant
+localparam REG_NONCE_START   = 9'h84;  // First nonce
+localparam REG_NONCE_COUNT   = 9'h88;  // Nonces to try (0 = all 2^32)
+localparam REG_NONCE_NEXT    = 9'h8C;  // R: next nonce to be tried
+localparam REG_FOUND         = 9'h90;  // R: oldest matching nonce
+localparam REG_FOUND_POP     = 9'h94;  // W: drop the oldest matching nonce
+
+localparam START_BIT    = 0;   // W: start a sweep (ignored while busy)
+localparam STOP_BIT     = 1;   // W: end the sweep after the current pass
+localparam DOUBLE_BIT   = 2;   // Config: SHA256d (hash the digest once more)
+localparam NONCE_LE_BIT = 3;   // Config: byte-swap the nonce into its word
+localparam CMP_LE_BIT   = 4;   // Config: compare the digest as a little-endian number
+// bits [11:8]                 // Config: template word that holds the nonce
+// R: bit 0 busy, bits [23:16] found count, bit 30 found overflow, bit 31 done
+
+localparam logic [31:0] SHA256_IV [0:7] = '{
+	32'h6a09e667, 32'hbb67ae85, 32'h3c6ef372, 32'ha54ff53a,
+	32'h510e527f, 32'h9b05688c, 32'h1f83d9ab, 32'h5be0cd19
+};
+
+localparam FW = $clog2(FOUND_DEPTH);
+
+if (LANES < 1 || LANES > 8)
+	$error("accelerator_nonce: LANES must be between 1 and 8");
+
+function logic [31:0] BSWAP(input logic [31:0] x);
+	return {x[7:0], x[15:8], x[23:16], x[31:24]};
+endfunction
+
+// Digest as the 256-bit number the target is compared against
+function logic [255:0] DIGEST_VALUE(input logic [31:0] s [0:7], input logic le);
+	logic [255:0] v;
+	for (int i = 0; i < 8; i++)
+		v[255 - 32*i -: 32] = s[i];
+	if (le)
+		for (int i = 0; i < 32; i++)
+			DIGEST_VALUE[8*i +: 8] = v[255 - 8*i -: 8];
+	else
+		DIGEST_VALUE = v;
+endfunction
+
+// ----------------------------------
+// Registers
+// ----------------------------------
+logic [31:0]	template_w [0:15];
+logic [31:0]	midstate   [0:7];
+logic [31:0]	target     [0:7];
+logic [31:0]	nonce_start, nonce_count;
+logic			cfg_double, cfg_nonce_le, cfg_cmp_le;
+logic [3:0]		cfg_word;
+
+logic			busy, done_flag, stop_req, found_ovf;
+logic [31:0]	nonce;          // Nonce of lane 0 in the current pass
+logic [32:0]	remaining;      // Nonces left including the current pass
+
+typedef enum logic [1:0] {
+	IDLE,       // Waiting for START
+	RUN1,       // Lanes hash the last block with their nonce
+	RUN2,       // SHA256d: lanes hash the first digest
+	PUSH        // Queue matching nonces, then advance
+} nonce_state_t;
+nonce_state_t state;
+
+logic [LANES-1:0]	hit;        // Lane matched in the current pass
+
+// ----------------------------------
+// Lanes
+// ----------------------------------
+logic [31:0]		lane_msg   [0:LANES-1][0:15];
+logic [31:0]		lane_state [0:LANES-1][0:7];
+logic [31:0]		lane_out   [0:LANES-1][0:7];
+logic [LANES-1:0]	lane_done;
+logic [LANES-1:0]	lane_hit;
+wire  [31:0]		lane_ctrl = {31'b0, (state == RUN1) || (state == RUN2)};
+
+// The cores latch msg_word in LOAD and read state_in until DONE; both stay
+// constant for the whole pass because they only depend on the FSM state,
+// the nonce and, in RUN2, the first pass's state_out.
+always_comb begin
+	for (int j = 0; j < LANES; j++) begin
+		for (int i = 0; i < 16; i++) begin
+			if (state == RUN2)
+				lane_msg[j][i] = (i < 8) ? lane_out[j][i] : (i == 8) ? 32'h8000_0000 : (i == 15) ? 32'd256 : 32'h0;
+			else if (i == cfg_word)
+				lane_msg[j][i] = cfg_nonce_le ? BSWAP(nonce + j) : (nonce + j);
+			else
+				lane_msg[j][i] = template_w[i];
+		end
+		lane_state[j] = (state == RUN2) ? SHA256_IV : midstate;
+		lane_hit[j]   = (DIGEST_VALUE(lane_out[j], cfg_cmp_le) <= {target[0], target[1], target[2], target[3],
+		                                                         target[4], target[5], target[6], target[7]})
+		                && (j < remaining);
+	end
+end
+
+// The lanes start together and run in lockstep, so one K ROM port serves all
+// of them (lane 0 drives the address)
+logic [5:0]		lane_k_addr [0:LANES-1];
+logic [31:0]	lane_k [0:0][0:ROUNDS_PER_CYCLE-1];
+
+accelerator_krom #(
+	.PORTS				(1),
+	.ROUNDS_PER_CYCLE	(ROUNDS_PER_CYCLE),
+	.ROM_STYLE			("distributed")
+) krom (
+	.clk		(clk),
+	.addr		(lane_k_addr[0:0]),
+	.k_word		(lane_k)
+);
+
+for (genvar j = 0; j < LANES; j++) begin : g_lane
+	accelerator #(
+		.ONLINE_SCHEDULE	(ONLINE_SCHEDULE),
+		.ROUNDS_PER_CYCLE	(ROUNDS_PER_CYCLE),
+		.SHARED_K			(1)
+	) accelerator (
+		.clk		(clk),
+		.wb_rst_i	(wb_rst_i),
+		.enable		(1'b1),              // Gates itself while idle
+		.control	(lane_ctrl),
+		.done		(lane_done[j]),
+		.overflow	(),
+		.msg_word	(lane_msg[j]),
+		.state_in	(lane_state[j]),
+		.state_out	(lane_out[j]),
+		.fsm_state	(),
+		.k_addr		(lane_k_addr[j]),
+		.k_word		(lane_k[0])
+	);
+end
+
+// ----------------------------------
+// Found FIFO
+// ----------------------------------
+logic			found_push, found_pop, found_full, found_empty;
+logic [31:0]	found_nonce, found_head;
+logic [FW:0]	found_count;
+logic [2:0]		hit_lane;
+
+always_comb begin
+	hit_lane = 0;
+	for (int j = LANES - 1; j >= 0; j--)    // Lowest lane first
+		if (hit[j]) hit_lane = j;
+end
+
+assign found_push  = (state == PUSH) && (hit != 0);
+assign found_nonce = nonce + hit_lane;
+assign found_pop   = reg_sel && reg_we && (reg_addr == REG_FOUND_POP);
+
+accelerator_fifo #(
+	.WIDTH	(32),
+	.DEPTH	(FOUND_DEPTH)
+) found (
+	.clk		(clk),
+	.wb_rst_i	(wb_rst_i),
+	.wr_en		(found_push),
+	.wr_data	(found_nonce),
+	.rd_en		(found_pop),
+	.rd_data	(found_head),
+	.full		(found_full),
+	.empty		(found_empty),
+	.count		(found_count)
+);
+
+assign done_o = (state == PUSH) && (hit == 0) && (remaining <= LANES || stop_req);
+
+// ----------------------------------
+// Register slave
+// ----------------------------------
+always_comb begin
+	reg_dat_o = 32'h0;
+	case (reg_addr)
+		REG_NONCE_CONTROL: reg_dat_o = {done_flag, found_ovf, 6'b0, 8'(found_count), 4'b0, cfg_word,
+		                               3'b0, cfg_cmp_le, cfg_nonce_le, cfg_double, 1'b0, busy};
+		REG_NONCE_START:   reg_dat_o = nonce_start;
+		REG_NONCE_COUNT:   reg_dat_o = nonce_count;
+		REG_NONCE_NEXT:    reg_dat_o = nonce;
+		REG_FOUND:         reg_dat_o = found_head;
+
+		9'h04,9'h08,9'h0C,9'h10,9'h14,9'h18,9'h1C,9'h20,
+		9'h24,9'h28,9'h2C,9'h30,9'h34,9'h38,9'h3C,9'h40:
+			reg_dat_o = template_w[(reg_addr - REG_TEMPLATE) >> 2];
+
+		9'h44,9'h48,9'h4C,9'h50,9'h54,9'h58,9'h5C,9'h60:
+			reg_dat_o = midstate[(reg_addr - REG_MIDSTATE) >> 2];
+
+		9'h64,9'h68,9'h6C,9'h70,9'h74,9'h78,9'h7C,9'h80:
+			reg_dat_o = target[(reg_addr - REG_TARGET) >> 2];
+	endcase
+end
+
+// ----------------------------------
+// Sweep FSM
+// ----------------------------------
+always_ff @(posedge clk or posedge wb_rst_i) begin
+	if (wb_rst_i) begin
+		foreach (template_w[i]) template_w[i] <= 0;
+		foreach (midstate[i]) midstate[i] <= 0;
+		foreach (target[i]) target[i] <= 0;
+		nonce_start  <= 32'h0;
+		nonce_count  <= 32'h0;
+		cfg_double   <= 1'b0;
+		cfg_nonce_le <= 1'b0;
+		cfg_cmp_le   <= 1'b0;
+		cfg_word     <= 4'd0;
+		busy         <= 1'b0;
+		done_flag    <= 1'b0;
+		stop_req     <= 1'b0;
+		found_ovf    <= 1'b0;
+		nonce        <= 32'h0;
+		remaining    <= 0;
+		hit          <= 0;
+		state        <= IDLE;
+	end else begin
+		// ----------- REGISTER WRITES (setup ignored while busy) ------------
+		if (reg_sel && reg_we) begin
+			if (reg_addr == REG_NONCE_CONTROL && reg_dat_i[STOP_BIT] && busy)
+				stop_req <= 1'b1;
+
+			if (!busy) begin
+				case (reg_addr)
+					REG_NONCE_CONTROL: begin
+						cfg_double   <= reg_dat_i[DOUBLE_BIT];
+						cfg_nonce_le <= reg_dat_i[NONCE_LE_BIT];
+						cfg_cmp_le   <= reg_dat_i[CMP_LE_BIT];
+						cfg_word     <= reg_dat_i[11:8];
+						if (reg_dat_i[START_BIT]) begin
+							nonce     <= nonce_start;
+							remaining <= (nonce_count == 0) ? 33'h1_0000_0000 : 33'(nonce_count);
+							busy      <= 1'b1;
+							done_flag <= 1'b0;
+							stop_req  <= 1'b0;
+							found_ovf <= 1'b0;
+							state     <= RUN1;
+						end
+					end
+					REG_NONCE_START: nonce_start <= reg_dat_i;
+					REG_NONCE_COUNT: nonce_count <= reg_dat_i;
+
+					9'h04,9'h08,9'h0C,9'h10,9'h14,9'h18,9'h1C,9'h20,
+					9'h24,9'h28,9'h2C,9'h30,9'h34,9'h38,9'h3C,9'h40:
+						template_w[(reg_addr - REG_TEMPLATE) >> 2] <= reg_dat_i;
+
+					9'h44,9'h48,9'h4C,9'h50,9'h54,9'h58,9'h5C,9'h60:
+						midstate[(reg_addr - REG_MIDSTATE) >> 2] <= reg_dat_i;
+
+					9'h64,9'h68,9'h6C,9'h70,9'h74,9'h78,9'h7C,9'h80:
+						target[(reg_addr - REG_TARGET) >> 2] <= reg_dat_i;
+				endcase
+			end
+		end
+
+		case (state)
+			IDLE: ;
+
+			// All lanes start together and take the same number of cycles
+			RUN1: if (lane_done[0]) begin
+				if (cfg_double)
+					state <= RUN2;
+				else begin
+					hit   <= lane_hit;
+					state <= PUSH;
+				end
+			end
+
+			RUN2: if (lane_done[0]) begin
+				hit   <= lane_hit;
+				state <= PUSH;
+			end
+
+			// One matching nonce per cycle, then the next pass
+			PUSH: if (hit != 0) begin
+				if (found_full)
+					found_ovf <= 1'b1;          // Dropped, software was too slow
+				hit[hit_lane] <= 1'b0;
+			end else if (remaining <= LANES || stop_req) begin
+				nonce     <= nonce + 32'((remaining < LANES) ? remaining : LANES);  // Resume point
+				busy      <= 1'b0;
+				done_flag <= 1'b1;
+				state     <= IDLE;
+			end else begin
+				nonce     <= nonce + LANES;
+				remaining <= remaining - LANES;
+				state     <= RUN1;
+			end
+
+			default: state <= IDLE;
+		endcase
+	end
+end
+
+endmodule
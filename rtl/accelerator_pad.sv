@@ -0,0 +1,39 @@
+// =====================================
+// SHA256 Padding Unit
+// - Finalizes the last message block of a stream in hardware:
+//   bytes [0, nbytes) are kept, byte nbytes becomes 0x80, the rest is zero
+// - The 64-bit message bit length goes into words 14/15 when it fits
+//   (nbytes <= 55); otherwise need_tail is set and the caller follows up
+//   with a zero block ending in the bit length
+// - Purely combinational; message words are big-endian (byte 0 in [31:24])
+// =====================================
+module accelerator_pad (
+	input	logic	[31:0]	msg_in  [0:15],   // Last block as written by software
+	input	logic	[5:0]	nbytes,           // Valid message bytes in msg_in (0-63)
+	input	logic	[63:0]	bitlen,           // Total message length in bits
+
+	output	logic	[31:0]	msg_out [0:15],   // Padded block
+	output	logic			need_tail         // Length did not fit, a length-only block follows
+);
+
+assign need_tail = (nbytes > 6'd55);
+
+always_comb begin
+	for (int i = 0; i < 16; i++) begin
+		for (int k = 0; k < 4; k++) begin
+			if (4*i + k < nbytes)
+				msg_out[i][31 - 8*k -: 8] = msg_in[i][31 - 8*k -: 8];
+			else if (4*i + k == nbytes)
+				msg_out[i][31 - 8*k -: 8] = 8'h80;
+			else
+				msg_out[i][31 - 8*k -: 8] = 8'h00;
+		end
+	end
+
+	if (!need_tail) begin
+		msg_out[14] = bitlen[63:32];
+		msg_out[15] = bitlen[31:0];
+	end
+end
+
+endmodule
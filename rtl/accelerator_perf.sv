@@ -0,0 +1,158 @@
+// =====================================
+// Performance Counters
+// - Per core: blocks finished, cycles in each core FSM state (IDLE split
+//   into idle and stalled), register reads/writes to the core's window
+// - Aggregate: clock cycles, blocks, register reads/writes, cycles with
+//   any core busy
+// - Counters run all the time; reads return the copy taken by the last
+//   SNAPSHOT, so one interval is read back consistently while traffic goes on
+// - SNAPSHOT and CLEAR in the same write copy the interval and start the
+//   next one, no cycle is lost in between
+// - Counters are 32 bits and wrap (about 43 s at 100 MHz)
+// =====================================
+module accelerator_perf #(
+	parameter NUM_CORES = 2
+) (
+	input	logic					clk,
+	input	logic					wb_rst_i,
+
+	// Register slave (performance block of the global window)
+	input	logic					reg_sel,       // Access targets the performance block
+	input	logic	[8:0]			reg_addr,      // Offset inside the block
+	input	logic	[31:0]			reg_dat_i,
+	output	logic	[31:0]			reg_dat_o,
+	input	logic					reg_we,
+
+	// Events, one entry per core
+	input	logic	[2:0]			core_state [0:NUM_CORES-1],  // accelerator FSM state
+	input	logic	[NUM_CORES-1:0]	core_done,     // Block finished this cycle
+	input	logic	[NUM_CORES-1:0]	core_stall,    // Nothing queued, waiting for software
+	input	logic	[NUM_CORES-1:0]	core_rd,       // Register read of the core's window
+	input	logic	[NUM_CORES-1:0]	core_wr,       // Register write of the core's window
+	input	logic					bus_rd,        // Any register read
+	input	logic					bus_wr         // Any register write
+);
+
+// ----------------------------------
+// Constants
+// ----------------------------------
+localparam REG_PERF_CONTROL = 9'h00;  // W: bit 0 snapshot, bit 1 clear, [11:8] core shown at 0x40. R: [11:8] core
+localparam REG_PERF_GLOBAL  = 9'h04;  // 0x04-0x14: aggregate counters
+localparam REG_PERF_CORE    = 9'h40;  // 0x40-0x60: counters of the selected core
+
+localparam SNAPSHOT_BIT = 0;
+localparam CLEAR_BIT    = 1;
+
+// Core FSM encoding (accelerator state_t)
+localparam ST_IDLE     = 3'd0;
+localparam ST_LOAD     = 3'd1;
+localparam ST_EXPAND   = 3'd2;
+localparam ST_COMPRESS = 3'd3;
+localparam ST_DONE     = 3'd4;
+
+// Per-core counters, in register order from REG_PERF_CORE
+localparam C_BLOCKS   = 0;   // Blocks finished
+localparam C_IDLE     = 1;   // IDLE, not waiting on software
+localparam C_LOAD     = 2;
+localparam C_EXPAND   = 3;
+localparam C_COMPRESS = 4;
+localparam C_DONE     = 5;
+localparam C_STALL    = 6;   // IDLE with a result waiting for the next GO or a collect
+localparam C_RD       = 7;
+localparam C_WR       = 8;
+localparam NC         = 9;
+
+// Aggregate counters, in register order from REG_PERF_GLOBAL
+localparam G_CYCLES   = 0;
+localparam G_BLOCKS   = 1;
+localparam G_RD       = 2;
+localparam G_WR       = 3;
+localparam G_BUSY     = 4;   // At least one core out of IDLE
+localparam NG         = 5;
+
+if (NUM_CORES < 1 || NUM_CORES > 16)
+	$error("accelerator_perf: NUM_CORES must be between 1 and 16");
+
+// ----------------------------------
+// Counters
+// ----------------------------------
+logic [31:0]	live [0:NUM_CORES-1][0:NC-1];
+logic [31:0]	snap [0:NUM_CORES-1][0:NC-1];
+logic [31:0]	glive [0:NG-1];
+logic [31:0]	gsnap [0:NG-1];
+logic [3:0]		sel_core;
+
+logic [4:0]		blocks;     // Blocks finished this cycle, all cores
+logic			any_busy;
+
+always_comb begin
+	blocks   = 5'd0;
+	any_busy = 1'b0;
+	for (int i = 0; i < NUM_CORES; i++) begin
+		blocks   = blocks + core_done[i];
+		any_busy = any_busy | (core_state[i] != ST_IDLE);
+	end
+end
+
+wire snapshot = reg_sel && reg_we && (reg_addr == REG_PERF_CONTROL) && reg_dat_i[SNAPSHOT_BIT];
+wire clear    = reg_sel && reg_we && (reg_addr == REG_PERF_CONTROL) && reg_dat_i[CLEAR_BIT];
+
+// ----------------------------------
+// Register slave
+// ----------------------------------
+always_comb begin
+	reg_dat_o = 32'h0;
+	if (reg_addr == REG_PERF_CONTROL)
+		reg_dat_o = {20'b0, sel_core, 8'b0};
+	else if (reg_addr >= REG_PERF_GLOBAL && reg_addr < REG_PERF_GLOBAL + 4*NG && reg_addr[1:0] == 2'b00)
+		reg_dat_o = gsnap[(reg_addr - REG_PERF_GLOBAL) >> 2];
+	else if (reg_addr >= REG_PERF_CORE && reg_addr < REG_PERF_CORE + 4*NC && reg_addr[1:0] == 2'b00
+	         && sel_core < NUM_CORES)
+		reg_dat_o = snap[sel_core][(reg_addr - REG_PERF_CORE) >> 2];
+end
+
+always_ff @(posedge clk or posedge wb_rst_i) begin
+	if (wb_rst_i) begin
+		foreach (live[i,j]) live[i][j] <= 0;
+		foreach (snap[i,j]) snap[i][j] <= 0;
+		foreach (glive[j]) glive[j] <= 0;
+		foreach (gsnap[j]) gsnap[j] <= 0;
+		sel_core <= 4'd0;
+	end else begin
+		if (reg_sel && reg_we && reg_addr == REG_PERF_CONTROL)
+			sel_core <= reg_dat_i[11:8];
+
+		if (snapshot) begin                 // Copy the interval before it is cleared
+			snap  <= live;
+			gsnap <= glive;
+		end
+
+		if (clear) begin
+			foreach (live[i,j]) live[i][j] <= 0;
+			foreach (glive[j]) glive[j] <= 0;
+		end else begin
+			for (int i = 0; i < NUM_CORES; i++) begin
+				live[i][C_BLOCKS] <= live[i][C_BLOCKS] + core_done[i];
+				live[i][C_RD]     <= live[i][C_RD] + core_rd[i];
+				live[i][C_WR]     <= live[i][C_WR] + core_wr[i];
+				case (core_state[i])
+					ST_IDLE:     if (core_stall[i]) live[i][C_STALL] <= live[i][C_STALL] + 1'b1;
+					             else               live[i][C_IDLE]  <= live[i][C_IDLE] + 1'b1;
+					ST_LOAD:     live[i][C_LOAD]     <= live[i][C_LOAD] + 1'b1;
+					ST_EXPAND:   live[i][C_EXPAND]   <= live[i][C_EXPAND] + 1'b1;
+					ST_COMPRESS: live[i][C_COMPRESS] <= live[i][C_COMPRESS] + 1'b1;
+					ST_DONE:     live[i][C_DONE]     <= live[i][C_DONE] + 1'b1;
+					default: ;
+				endcase
+			end
+
+			glive[G_CYCLES] <= glive[G_CYCLES] + 1'b1;
+			glive[G_BLOCKS] <= glive[G_BLOCKS] + blocks;
+			glive[G_RD]     <= glive[G_RD] + bus_rd;
+			glive[G_WR]     <= glive[G_WR] + bus_wr;
+			glive[G_BUSY]   <= glive[G_BUSY] + any_busy;
+		end
+	end
+end
+
+endmodule
@@ -0,0 +1,134 @@
+// SHA256 Fully Pipelined Core
+// - One compression round per pipeline stage (64 stages + final addition)
+// - Accepts a new msg_word/state_in pair every clock once the pipe is full
+// - Every block carries a job tag so results can be matched in any order
+// - Latency: 66 clocks from in_valid to out_valid (input stage + 64 rounds + final add)
+module accelerator_pipe #(
+    parameter TAG_W = 8
+) (
+    input  logic               clk,         // Clock input
+    input  logic               wb_rst_i,    // Reset signal (active high)
+
+    input  logic               in_valid,    // Block presented on msg_word/state_in
+    input  logic [TAG_W-1:0]   in_tag,      // Job tag travelling with the block
+    input  logic [31:0]        msg_word [0:15],   // 512-bit message block (16 x 32-bit words)
+    input  logic [31:0]        state_in [0:7],    // Initial SHA256 state (8 x 32-bit words)
+
+    output logic               out_valid,   // state_out/out_tag hold a finished block
+    output logic [TAG_W-1:0]   out_tag,
+    output logic [31:0]        state_out [0:7]    // Output SHA256 state (after processing one block)
+);
+
+// ---- SHA256 Constants ----
+localparam logic [31:0] K [0:63] = '{
+    32'h428a2f98, 32'h71374491, 32'hb5c0fbcf, 32'he9b5dba5, 32'h3956c25b, 32'h59f111f1, 32'h923f82a4, 32'hab1c5ed5,
+    32'hd807aa98, 32'h12835b01, 32'h243185be, 32'h550c7dc3, 32'h72be5d74, 32'h80deb1fe, 32'h9bdc06a7, 32'hc19bf174,
+    32'he49b69c1, 32'hefbe4786, 32'h0fc19dc6, 32'h240ca1cc, 32'h2de92c6f, 32'h4a7484aa, 32'h5cb0a9dc, 32'h76f988da,
+    32'h983e5152, 32'ha831c66d, 32'hb00327c8, 32'hbf597fc7, 32'hc6e00bf3, 32'hd5a79147, 32'h06ca6351, 32'h14292967,
+    32'h27b70a85, 32'h2e1b2138, 32'h4d2c6dfc, 32'h53380d13, 32'h650a7354, 32'h766a0abb, 32'h81c2c92e, 32'h92722c85,
+    32'ha2bfe8a1, 32'ha81a664b, 32'hc24b8b70, 32'hc76c51a3, 32'hd192e819, 32'hd6990624, 32'hf40e3585, 32'h106aa070,
+    32'h19a4c116, 32'h1e376c08, 32'h2748774c, 32'h34b0bcb5, 32'h391c0cb3, 32'h4ed8aa4a, 32'h5b9cca4f, 32'h682e6ff3,
+    32'h748f82ee, 32'h78a5636f, 32'h84c87814, 32'h8cc70208, 32'h90befffa, 32'ha4506ceb, 32'hbef9a3f7, 32'hc67178f2
+};
+
+// ---- SHA256 Helper Functions ----
+function logic [31:0] ROTR(input logic [31:0] x, input int n);
+    return (x >> n) | (x << (32 - n));
+endfunction
+
+function logic [31:0] EP0(input logic [31:0] x);
+    return ROTR(x,2) ^ ROTR(x,13) ^ ROTR(x,22);
+endfunction
+
+function logic [31:0] EP1(input logic [31:0] x);
+    return ROTR(x,6) ^ ROTR(x,11) ^ ROTR(x,25);
+endfunction
+
+function logic [31:0] CH(input logic [31:0] x, y, z);
+    return (x & y) ^ (~x & z);
+endfunction
+
+function logic [31:0] MAJ(input logic [31:0] x, y, z);
+    return (x & y) ^ (x & z) ^ (y & z);
+endfunction
+
+function logic [31:0] SIG0(input logic [31:0] x);
+    return ROTR(x,7) ^ ROTR(x,18) ^ (x >> 3);
+endfunction
+
+function logic [31:0] SIG1(input logic [31:0] x);
+    return ROTR(x,17) ^ ROTR(x,19) ^ (x >> 10);
+endfunction
+
+// ---- Pipeline registers ----
+// Stage s holds the working variables *before* round s and the schedule
+// window W[s..s+15]; stage 64 holds the result of the last round.
+// The input state travels along for the final addition. Only the valid
+// bits are reset; the datapath is qualified by them.
+logic               p_valid [0:64];
+logic [TAG_W-1:0]   p_tag   [0:64];
+logic [31:0]        p_work  [0:64][0:7];    // a..h
+logic [31:0]        p_w     [0:64][0:15];   // Schedule window
+logic [31:0]        p_init  [0:64][0:7];    // state_in for the final add
+
+// Stage 0: capture the incoming block
+always_ff @(posedge clk or posedge wb_rst_i)
+    if (wb_rst_i)
+        p_valid[0] <= 1'b0;
+    else
+        p_valid[0] <= in_valid;
+
+always_ff @(posedge clk) begin
+    p_tag[0]  <= in_tag;
+    p_work[0] <= state_in;
+    p_w[0]    <= msg_word;
+    p_init[0] <= state_in;
+end
+
+// Stages 1..64: one compression round each
+for (genvar s = 0; s < 64; s++) begin : g_round
+    logic [31:0] t1, t2;
+
+    assign t1 = p_work[s][7] + EP1(p_work[s][4]) + CH(p_work[s][4], p_work[s][5], p_work[s][6]) + K[s] + p_w[s][0];
+    assign t2 = EP0(p_work[s][0]) + MAJ(p_work[s][0], p_work[s][1], p_work[s][2]);
+
+    always_ff @(posedge clk or posedge wb_rst_i)
+        if (wb_rst_i)
+            p_valid[s+1] <= 1'b0;
+        else
+            p_valid[s+1] <= p_valid[s];
+
+    always_ff @(posedge clk) begin
+        p_tag[s+1]     <= p_tag[s];
+        p_init[s+1]    <= p_init[s];
+
+        // Shift values and update working variables
+        p_work[s+1][0] <= t1 + t2;
+        p_work[s+1][1] <= p_work[s][0];
+        p_work[s+1][2] <= p_work[s][1];
+        p_work[s+1][3] <= p_work[s][2];
+        p_work[s+1][4] <= p_work[s][3] + t1;
+        p_work[s+1][5] <= p_work[s][4];
+        p_work[s+1][6] <= p_work[s][5];
+        p_work[s+1][7] <= p_work[s][6];
+
+        // Slide the schedule window and append W[s+16] (unused words are trimmed by synthesis)
+        for (int i = 0; i < 15; i++) p_w[s+1][i] <= p_w[s][i+1];
+        p_w[s+1][15] <= SIG1(p_w[s][14]) + p_w[s][9] + SIG0(p_w[s][1]) + p_w[s][0];
+    end
+end
+
+// Final stage: add working variables back to the original state
+always_ff @(posedge clk or posedge wb_rst_i)
+    if (wb_rst_i)
+        out_valid <= 1'b0;
+    else
+        out_valid <= p_valid[64];
+
+always_ff @(posedge clk) begin
+    out_tag <= p_tag[64];
+    for (int i = 0; i < 8; i++)
+        state_out[i] <= p_work[64][i] + p_init[64][i];
+end
+
+endmodule
@@ -1,36 +1,72 @@
 // =====================================
-// Register File for Dual SHA256 Accelerators
+// Register File for N SHA256 Accelerators
 // Handles reads/writes to accelerator input/output via memory-mapped registers
-// Supports 2 cores (core 0 at base 0x80001300, core 1 at 0x80001500)
+// Supports NUM_CORES cores (core 0 at base 0x80001300, core 1 at 0x80001500, ...)
+// Each core owns a 0x200-byte window; address bits [12:9] select the core
+// Address bit 13 selects the global window (core info, job dispatcher, pipelined core)
+// Each core has two message/state banks: software fills one while the core
+// hashes the other, and GO queues the filled bank behind the running one
+// GO with CONTINUE chains the block onto the core's previous result, so a
+// long message only moves message words over the bus
+// GO with FINAL pads the last block in hardware (accelerator_pad) from the
+// valid byte count and the BITLEN registers, adding a length block if needed;
+// with AUTO_LEN the length comes from the core's own block counter instead
+// FINAL with DOUBLE or HMAC queues one more block after the stream: the
+// digest hashed again (SHA256d) or hashed under a cached opad midstate (HMAC)
+// Offset bit 8 of a core, job or pipe window selects its little-endian view:
+// message words and state_out are byte-swapped, so a RISC-V word load/store
+// of the message or digest bytes needs no packing in software
+// Each core keeps CTX_SLOTS context slots (chained state and AUTO_LEN block
+// count); the context ID in REG_CONTROL picks the slot a GO chains from and
+// finishes into, so open streams interleave without state readback
+// Tagged jobs retire out of order into a completion FIFO of {tag, state_out}
+// REG_CORE_ENABLE parks cores (no clock enable, skipped by the job dispatcher);
+// enabled cores still stop their clock by themselves whenever they are idle
+// Performance counters (accelerator_perf) account every core cycle by FSM
+// state and count blocks and register traffic, read back through snapshots
 // =====================================
 module accelerator_regs
-#(parameter SIM = 0)
+#(parameter SIM = 0,
+  parameter NUM_CORES = 2,
+  parameter PIPE_CORE = 0,          // 1 = pipelined core present behind the pipe window
+  parameter PIPE_FIFO_DEPTH = 16,   // Tagged results buffered for the pipelined core
+  parameter JOB_FIFO_DEPTH = 16,    // Tagged job completions buffered for software
+  parameter HMAC_SLOTS = 4,         // Cached ipad/opad midstate pairs (1-4)
+  parameter CTX_SLOTS = 4,          // Stream contexts per core (1, 2, 4, 8 or 16)
+  parameter PERF_COUNTERS = 1,      // 1 = performance counter block present
+  parameter EXT_FEATURES = 8'h00)   // REG_ID feature bits of blocks outside the register file
  (
 	input	logic					clk,         // Clock
 	input	logic					wb_rst_i,    // Reset (active high)
 
 	// Wishbone input interface
-	input	logic	[7:0]			wb_addr_i,   // Register address (offset)
+	input	logic	[13:0]			wb_addr_i,   // Register address (offset)
 	input	logic	[31:0]			wb_dat_i,    // Data to write
 	output	logic	[31:0]			wb_dat_o,    // Data to read
 	input	logic					wb_we_i,     // Write enable
 	input	logic					wb_re_i,     // Read enable
 
-	// Accelerator 0 input/output
-	input	logic					overflow0,
-	input	logic					done0,
-	output	logic	[31:0]			control0,
-	output	logic	[31:0]			msg_word0 [0:15],  // 512-bit input block
-	output	logic	[31:0]			state_in0 [0:7],   // Input hash state
-	input	logic	[31:0]			state_out0 [0:7],  // Output hash state
-
-	// Accelerator 1 input/output
-	input	logic					overflow1,
-	input	logic					done1,
-	output	logic	[31:0]			control1,
-	output	logic	[31:0]			msg_word1 [0:15],
-	output	logic	[31:0]			state_in1 [0:7],
-	input	logic	[31:0]			state_out1 [0:7]
+	// Accelerator input/output, one entry per core
+	input	logic	[NUM_CORES-1:0]	overflow,
+	input	logic	[NUM_CORES-1:0]	done,
+	output	logic	[31:0]			control   [0:NUM_CORES-1],        // GO = active bank queued
+	output	logic	[31:0]			msg_word  [0:NUM_CORES-1][0:15],  // 512-bit input block (active bank)
+	output	logic	[31:0]			state_in  [0:NUM_CORES-1][0:7],   // Input hash state (active bank)
+	input	logic	[31:0]			state_out [0:NUM_CORES-1][0:7],   // Output hash state
+	input	logic	[2:0]			core_state [0:NUM_CORES-1],       // Core FSM state (performance counters)
+	output	logic	[NUM_CORES-1:0]	core_en,                          // REG_CORE_ENABLE
+
+	// Pipelined core input/output
+	output	logic					pipe_in_valid,
+	output	logic	[7:0]			pipe_in_tag,
+	output	logic	[31:0]			pipe_msg_word [0:15],
+	output	logic	[31:0]			pipe_state_in [0:7],
+	input	logic					pipe_out_valid,
+	input	logic	[7:0]			pipe_out_tag,
+	input	logic	[31:0]			pipe_state_out [0:7],
+
+	input	logic	[2:0]			engine_done, // DMA, nonce, Merkle: one-cycle pulse when a job ends
+	output	logic					irq          // Level interrupt: a masked IRQ_STATUS bit is set
 );
 
 // ----------------------------------
@@ -38,22 +74,376 @@ module accelerator_regs
 // ----------------------------------
 localparam REG_CONTROL  = 8'h00;   // Control register offset
 localparam REG_STATUS   = 8'h84;   // Status register offset
-localparam ADDR_BASE1   = 8'h200;  // Base address offset for core 1
+localparam REG_BITLEN_HI = 8'h88;  // Total message bit length [63:32] (for FINAL)
+localparam REG_BITLEN_LO = 8'h8C;  // Total message bit length [31:0]
+localparam REG_CTX_SEL   = 8'h90;  // Context shown at state_out. R: {CTX_SLOTS[15:8], context[3:0]}
+
+// Global window (base offset 0x2000), split into 0x200-byte blocks
+localparam BLK_INFO     = 4'h0;    // 0x2000: core info
+localparam BLK_JOB      = 4'h1;    // 0x2200: shared job dispatcher (same layout as a core window)
+localparam BLK_PIPE     = 4'h2;    // 0x2400: pipelined core (core window layout + result pop)
+// 4'h3                        // 0x2600: DMA engine (decoded in accelerator_top)
+// 4'h4                        // 0x2800: nonce sweep engine (decoded in accelerator_top)
+localparam BLK_HMAC     = 4'h5;    // 0x2A00: HMAC key slots, 0x40 bytes each (ipad state, opad state)
+// 4'h6                        // 0x2C00: Merkle tree engine (decoded in accelerator_top)
+localparam BLK_PERF     = 4'h7;    // 0x2E00: performance counters (accelerator_perf)
+
+localparam REG_ID        = 8'h00;  // Info: {16'h5348, FEATURES, NUM_CORES}
+localparam REG_IDLE_MASK = 8'h04;  // Info: one bit per core that can take a job
+localparam REG_DONE_MASK = 8'h08;  // Info: one bit per core with DONE set
+localparam REG_IRQ_STATUS = 8'h0C; // Info: one bit per core whose queue drained, engines above (write 1 to clear)
+localparam REG_IRQ_MASK  = 8'h10;  // Info: IRQ_STATUS bits that drive irq
+localparam IRQ_ENGINE_LSB = 16;    // IRQ_STATUS bits [18:16]: DMA, nonce, Merkle engine done
+localparam IRQ_W         = IRQ_ENGINE_LSB + 3;
+localparam REG_CORE_ENABLE = 8'h14; // Info: one bit per core that may run (reset: all)
+
+localparam REG_PIPE_POP  = 8'h88;  // Pipe: write to drop the head result
+localparam REG_JOB_TAG   = 8'h90;  // Job: tag of the oldest completion
+localparam REG_JOB_POP   = 8'h94;  // Job: write to drop the oldest completion
 
 localparam GO_BIT       = 0;
+localparam CONT_BIT     = 1;       // Use the previous state_out as state_in
+localparam FINAL_BIT    = 2;       // Pad the block; bits [13:8] = valid message bytes
+localparam DOUBLE_BIT   = 3;       // With FINAL: hash the digest once more (SHA256d)
+localparam HMAC_BIT     = 4;       // With FINAL: outer hash under the slot's opad state
+localparam IPAD_BIT     = 5;       // Take state_in from the slot's ipad state
+localparam AUTOLEN_BIT  = 6;       // With FINAL: bit length = blocks since the stream start + bytes
+localparam TAGGED_BIT   = 7;       // Job window: result goes to the completion FIFO, tag in [23:16]
+localparam SLOT_LSB     = 16;      // Bits [17:16]: HMAC key slot
+localparam CTX_LSB      = 24;      // Bits [27:24]: context slot (core window)
 localparam DONE_BIT     = 31;
 
+// REG_STATUS bits (core window)
+localparam OVF_BIT      = 0;       // Sticky: GO while both banks were queued (cleared by writing REG_STATUS)
+localparam FULL_BIT     = 1;       // Fill bank (or a length block) still queued, wait before writing the next block
+// bits [3:2]             // Number of queued/running blocks (0-2)
+
+// REG_ID feature bits
+localparam FEAT_PIPE    = 0;       // Pipelined core present
+localparam FEAT_HMAC    = 3;       // DOUBLE/HMAC outer hash and key slots
+localparam FEAT_PERF    = 5;       // Performance counters present
+// bit 1                       // DMA engine present (EXT_FEATURES)
+// bit 2                       // Nonce sweep engine present (EXT_FEATURES)
+// bit 4                       // Merkle tree engine present (EXT_FEATURES)
+
+wire [7:0] features = 8'((PIPE_CORE != 0) << FEAT_PIPE) | 8'(1 << FEAT_HMAC)
+                    | 8'((PERF_COUNTERS != 0) << FEAT_PERF) | 8'(EXT_FEATURES);
+
+localparam logic [31:0] SHA256_IV [0:7] = '{
+	32'h6a09e667, 32'hbb67ae85, 32'h3c6ef372, 32'ha54ff53a,
+	32'h510e527f, 32'h9b05688c, 32'h1f83d9ab, 32'h5be0cd19
+};
+
+if (NUM_CORES < 1 || NUM_CORES > 16)
+	$error("accelerator_regs: NUM_CORES must be between 1 and 16");
+if (HMAC_SLOTS < 1 || HMAC_SLOTS > 4)
+	$error("accelerator_regs: HMAC_SLOTS must be between 1 and 4");
+if (CTX_SLOTS < 1 || CTX_SLOTS > 16 || (CTX_SLOTS & (CTX_SLOTS - 1)) != 0)
+	$error("accelerator_regs: CTX_SLOTS must be 1, 2, 4, 8 or 16");
+
 // ----------------------------------
 // Address decoding
 // ----------------------------------
-// sel0 = true if accessing core 0
-// sel1 = true if accessing core 1
-logic sel0 = (wb_addr_i < ADDR_BASE1);
-logic sel1 = (wb_addr_i >= ADDR_BASE1);
+// sel_global = true if accessing the global window
+// sel_blk    = core index (or global block index) of the access
+// offset     = register offset inside the selected window
+wire		sel_global = wb_addr_i[13];
+wire [3:0]	sel_blk    = wb_addr_i[12:9];
+wire [8:0]	offset     = wb_addr_i[8:0];
+wire		sel_core   = !sel_global && (sel_blk < NUM_CORES);
+wire		sel_job    = sel_global && (sel_blk == BLK_JOB);
+wire		sel_pipe   = sel_global && (sel_blk == BLK_PIPE) && (PIPE_CORE != 0);
+wire		sel_hmac   = sel_global && (sel_blk == BLK_HMAC) && (offset[7:6] < HMAC_SLOTS);
+wire		sel_perf   = sel_global && (sel_blk == BLK_PERF) && (PERF_COUNTERS != 0);
+wire		le_view    = offset[8];         // Core/job/pipe window: byte-swapped msg/state_out view
+wire [7:0]	core_off   = offset[7:0];
+
+function logic [31:0] BSWAP(input logic [31:0] x);
+	return {x[7:0], x[15:8], x[23:16], x[31:24]};
+endfunction
+
+function logic [31:0] VIEW(input logic [31:0] x, input logic le);
+	return le ? BSWAP(x) : x;
+endfunction
+
+// ----------------------------------
+// Per-core context slots
+// ----------------------------------
+// DONE stores state_out into the slot of the bank that ran, CONTINUE chains
+// from that slot, and the tail and outer blocks of a FINAL inherit its
+// context. Slot 0 serves GOs without a context ID and dispatched jobs.
+// state_out reads show the REG_CTX_SEL slot, which every accepted GO also
+// sets, so a single stream (or the DMA engine) never has to select it.
+// Explicit BITLEN stays per core: the FINAL write consumes it right away.
+logic [31:0] ctx_state  [0:NUM_CORES-1][0:CTX_SLOTS-1][0:7];  // Last result of each context
+logic [31:0] ctx_blocks [0:NUM_CORES-1][0:CTX_SLOTS-1];       // Blocks since the context's stream start
+logic [3:0]  view_ctx   [0:NUM_CORES-1];                      // REG_CTX_SEL
+logic [3:0]  fin_ctx    [0:NUM_CORES-1];                      // Context of the pending tail/outer block
+
+wire [3:0] go_ctx = wb_dat_i[CTX_LSB +: 4] & 4'(CTX_SLOTS - 1);
+
+// An IPAD or HMAC GO naming a key slot that is not built is dropped like an
+// overflow, so the slot arrays are never indexed out of range
+wire [1:0] go_slot     = wb_dat_i[SLOT_LSB +: 2];
+wire       go_slot_bad = (wb_dat_i[IPAD_BIT] || wb_dat_i[HMAC_BIT]) && (go_slot >= HMAC_SLOTS);
+
+// ----------------------------------
+// Per-core ping-pong banks
+// ----------------------------------
+// Bus writes go to bank wr_bank, the core executes bank rd_bank. GO marks
+// the fill bank valid and flips wr_bank; DONE clears the executed bank and
+// flips rd_bank, so the next queued block starts right away.
+logic [31:0]			bank_msg   [0:NUM_CORES-1][0:1][0:15];
+logic [31:0]			bank_state [0:NUM_CORES-1][0:1][0:7];
+logic [1:0]				bank_valid [0:NUM_CORES-1];
+logic [1:0]				bank_chain [0:NUM_CORES-1]; // Bank was queued with CONTINUE
+logic [1:0]				bank_last  [0:NUM_CORES-1]; // Bank closes a stream: raises the interrupt when it drains
+logic [3:0]				bank_ctx   [0:NUM_CORES-1][0:1];  // Context slot of the bank
+logic [NUM_CORES-1:0]	wr_bank, rd_bank;
+logic [NUM_CORES-1:0]	done_flag;              // DONE bit seen by software
+logic [NUM_CORES-1:0]	queue_ovf;
+logic [31:0]			bitlen_hi [0:NUM_CORES-1];
+logic [31:0]			bitlen_lo [0:NUM_CORES-1];
+logic [NUM_CORES-1:0]	tail_pending;           // FINAL block needs a length block queued after it
+logic [NUM_CORES-1:0]	outer_pending;          // Outer block (SHA256d/HMAC) follows the stream
+logic [NUM_CORES-1:0]	outer_hmac;             // Outer block uses the opad state, not the IV
+logic [1:0]				outer_slot [0:NUM_CORES-1];
+logic [NUM_CORES-1:0]	fill_busy;              // Fill bank cannot take a new block
+logic [IRQ_W-1:0]		irq_status;             // Core: last queued block finished. Engine: job ended
+logic [IRQ_W-1:0]		irq_mask;
+
+assign irq = |(irq_status & irq_mask);
+
+always_comb
+	for (int i = 0; i < NUM_CORES; i++)
+		fill_busy[i] = bank_valid[i][wr_bank[i]] || tail_pending[i] || outer_pending[i];
+
+// ----------------------------------
+// HMAC key slots
+// ----------------------------------
+// Software precomputes SHA256 of (key ^ ipad) and (key ^ opad) once per key;
+// a submission then names the slot instead of moving the states every time.
+logic [31:0]	hmac_ipad [0:HMAC_SLOTS-1][0:7];
+logic [31:0]	hmac_opad [0:HMAC_SLOTS-1][0:7];
+
+// ----------------------------------
+// Hardware padding of FINAL blocks
+// ----------------------------------
+// A FINAL GO replaces the fill bank with its padded version. When the bit
+// length does not fit, tail_pending queues a zero block ending in BITLEN
+// (chained with CONTINUE) as soon as the fill bank frees up again.
+// AUTO_LEN counts the stream from its first block (the ipad block of an
+// HMAC included), so a 64-byte-aligned message ends with one control write.
+logic [31:0]	pad_msg [0:15];
+logic			pad_need_tail;
+logic [31:0]	go_blocks;      // Full blocks of the stream before this GO
+logic [63:0]	pad_bitlen;
+
+always_comb begin
+	go_blocks  = wb_dat_i[CONT_BIT] ? ctx_blocks[sel_blk][go_ctx] : 32'(wb_dat_i[IPAD_BIT]);
+	pad_bitlen = wb_dat_i[AUTOLEN_BIT] ? {23'b0, go_blocks, 9'b0} | 64'({wb_dat_i[13:8], 3'b000})
+	                                   : {bitlen_hi[sel_blk], bitlen_lo[sel_blk]};
+end
+
+accelerator_pad pad (
+	.msg_in		(bank_msg[sel_blk][wr_bank[sel_blk]]),
+	.nbytes		(wb_dat_i[13:8]),
+	.bitlen		(pad_bitlen),
+	.msg_out	(pad_msg),
+	.need_tail	(pad_need_tail)
+);
 
-// Internal shadow registers to hold result after accelerator is done
-logic [31:0] latched_state_out0 [0:7];
-logic [31:0] latched_state_out1 [0:7];
+always_comb begin
+	for (int i = 0; i < NUM_CORES; i++) begin
+		control[i]  = {31'b0, bank_valid[i][rd_bank[i]]};
+		msg_word[i] = bank_msg[i][rd_bank[i]];
+		state_in[i] = bank_chain[i][rd_bank[i]] ? ctx_state[i][bank_ctx[i][rd_bank[i]]] : bank_state[i][rd_bank[i]];
+	end
+end
+
+// ----------------------------------
+// Job dispatcher state
+// ----------------------------------
+// Software fills the job window and writes GO; the job is copied into the
+// lowest-numbered free core as soon as one exists. A core is free while it
+// has no bank queued and DONE clear, so software releases a core after
+// collecting its result by writing 0 to that core's REG_CONTROL.
+// A job submitted with TAGGED retires by itself instead: when its core has
+// drained, {tag, state_out} is pushed into the completion FIFO and the core
+// is free again. Jobs finish in any order, so software matches them by tag.
+// GO may also carry FINAL and a byte count; the job is then padded with the
+// job window's BITLEN, exactly like a FINAL block in a core window.
+logic [31:0]			job_msg   [0:15];
+logic [31:0]			job_state [0:7];
+logic [31:0]			job_bitlen_hi, job_bitlen_lo;
+logic					job_pending;            // Submitted, waiting for a free core
+logic [3:0]				job_core;               // Core that took the last job
+logic					job_final, job_tagged;
+logic [5:0]				job_nbytes;
+logic [7:0]				job_tag;
+
+logic [31:0]			job_pad_msg [0:15];
+logic					job_pad_need_tail;
+
+accelerator_pad job_pad (
+	.msg_in		(job_msg),
+	.nbytes		(job_nbytes),
+	.bitlen		({job_bitlen_hi, job_bitlen_lo}),
+	.msg_out	(job_pad_msg),
+	.need_tail	(job_pad_need_tail)
+);
+
+// Tagged jobs: one retiring core per cycle moves its result into the FIFO
+localparam JOB_CW = $clog2(JOB_FIFO_DEPTH);
+
+logic [NUM_CORES-1:0]	core_tagged;            // Core runs a tagged job
+logic [7:0]				core_tag [0:NUM_CORES-1];
+logic [NUM_CORES-1:0]	res_ready;              // Tagged job drained, result in context slot 0
+logic					res_any;
+logic [3:0]				res_core;
+logic					job_res_push, job_res_pop, job_res_full, job_res_empty;
+logic [8+256-1:0]		job_res_in, job_res;
+logic [JOB_CW:0]		job_res_count;
+
+always_comb begin
+	res_any  = 1'b0;
+	res_core = 4'd0;
+	for (int i = NUM_CORES - 1; i >= 0; i--) begin  // Lowest index wins
+		if (res_ready[i]) begin
+			res_any  = 1'b1;
+			res_core = i;
+		end
+	end
+	job_res_in[263:256] = core_tag[res_core];
+	for (int i = 0; i < 8; i++)
+		job_res_in[255 - 32*i -: 32] = ctx_state[res_core][0][i];
+end
+
+assign job_res_push = res_any && !job_res_full;   // A full FIFO holds the core back
+assign job_res_pop  = wb_we_i && sel_job && (core_off == REG_JOB_POP) && !job_res_empty;
+
+accelerator_fifo #(
+	.WIDTH	(8 + 256),
+	.DEPTH	(JOB_FIFO_DEPTH)
+) job_results (
+	.clk		(clk),
+	.wb_rst_i	(wb_rst_i),
+	.wr_en		(job_res_push),
+	.wr_data	(job_res_in),
+	.rd_en		(job_res_pop),
+	.rd_data	(job_res),
+	.full		(job_res_full),
+	.empty		(job_res_empty),
+	.count		(job_res_count)
+);
+
+logic [NUM_CORES-1:0]	free_mask;
+logic [NUM_CORES-1:0]	done_mask;
+logic					free_any;
+logic [3:0]				free_core;
+
+// A bus GO landing on a core window fills that core's bank in this cycle, so
+// the dispatcher must not pick the same core until the GO shows in bank_valid
+wire bus_go = wb_we_i && sel_core && (core_off == REG_CONTROL) && wb_dat_i[GO_BIT];
+
+always_comb begin
+	free_any  = 1'b0;
+	free_core = 4'd0;
+	for (int i = 0; i < NUM_CORES; i++) begin
+		free_mask[i] = !(|bank_valid[i]) && !tail_pending[i] && !outer_pending[i] && !done_flag[i] && core_en[i]
+		               && !(bus_go && sel_blk == i);
+		done_mask[i] = done_flag[i];
+	end
+	for (int i = NUM_CORES - 1; i >= 0; i--) begin  // Lowest index wins
+		if (free_mask[i]) begin
+			free_any  = 1'b1;
+			free_core = i;
+		end
+	end
+end
+
+// ----------------------------------
+// Pipelined core state
+// ----------------------------------
+// Software stages a block in the pipe window and writes GO with a tag in
+// bits [15:8]. Finished blocks land in a FIFO as {tag, state_out} and are
+// read head-first; writing REG_PIPE_POP drops the head. A submission is
+// only accepted while every block in flight is guaranteed a FIFO entry,
+// otherwise it is dropped and the sticky overflow bit is set.
+localparam PIPE_CW = $clog2(PIPE_FIFO_DEPTH);
+
+logic [PIPE_CW:0]		pipe_used;              // Blocks in flight + results not yet popped
+logic					pipe_overflow;
+logic					pipe_pop;
+logic [8+256-1:0]		pipe_res_in, pipe_res;
+logic					pipe_res_empty;
+logic [PIPE_CW:0]		pipe_res_count;
+
+wire pipe_full = (pipe_used == PIPE_FIFO_DEPTH);
+
+always_comb begin
+	pipe_res_in[263:256] = pipe_out_tag;
+	for (int i = 0; i < 8; i++)
+		pipe_res_in[255 - 32*i -: 32] = pipe_state_out[i];
+end
+
+assign pipe_pop = wb_we_i && sel_pipe && (core_off == REG_PIPE_POP) && !pipe_res_empty;
+
+accelerator_fifo #(
+	.WIDTH	(8 + 256),
+	.DEPTH	(PIPE_FIFO_DEPTH)
+) pipe_results (
+	.clk		(clk),
+	.wb_rst_i	(wb_rst_i),
+	.wr_en		(pipe_out_valid),
+	.wr_data	(pipe_res_in),
+	.rd_en		(pipe_pop),
+	.rd_data	(pipe_res),
+	.full		(),
+	.empty		(pipe_res_empty),
+	.count		(pipe_res_count)
+);
+
+// ----------------------------------
+// Performance counters
+// ----------------------------------
+// A core stalls while it has finished and nothing is queued behind it
+// with DONE still set: the result waits for the next GO or a collect.
+logic [31:0]	perf_dat_o;
+
+if (PERF_COUNTERS) begin : g_perf
+	logic [NUM_CORES-1:0]	core_stall, core_rd, core_wr;
+
+	always_comb
+		for (int i = 0; i < NUM_CORES; i++) begin
+			core_stall[i] = done_flag[i] && !(|bank_valid[i]) && !tail_pending[i] && !outer_pending[i];
+			core_rd[i]    = wb_re_i && sel_core && (sel_blk == i);
+			core_wr[i]    = wb_we_i && sel_core && (sel_blk == i);
+		end
+
+	accelerator_perf #(
+		.NUM_CORES	(NUM_CORES)
+	) perf (
+		.clk		(clk),
+		.wb_rst_i	(wb_rst_i),
+
+		.reg_sel	(sel_perf),
+		.reg_addr	(offset),
+		.reg_dat_i	(wb_dat_i),
+		.reg_dat_o	(perf_dat_o),
+		.reg_we		(wb_we_i),
+
+		.core_state	(core_state),
+		.core_done	(done),
+		.core_stall	(core_stall),
+		.core_rd	(core_rd),
+		.core_wr	(core_wr),
+		.bus_rd		(wb_re_i),
+		.bus_wr		(wb_we_i)
+	);
+end else begin : g_no_perf
+	assign perf_dat_o = 32'h0;
+end
 
 // ----------------------------------
 // READ logic: connect CPU to register file
@@ -61,112 +451,329 @@ logic [31:0] latched_state_out1 [0:7];
 always_comb begin
 	wb_dat_o = 32'h0;  // Default read value
 
-	if (sel0) begin  // Accessing core 0
-		case (wb_addr_i)
-			REG_CONTROL: wb_dat_o = control0;
-			REG_STATUS:  wb_dat_o = {31'b0, overflow0};
+	if (sel_core) begin  // Accessing a core window
+		case (core_off)
+			REG_CONTROL: wb_dat_o = {done_flag[sel_blk], 30'b0,
+			                         |bank_valid[sel_blk] | tail_pending[sel_blk] | outer_pending[sel_blk]};
+			REG_STATUS:  wb_dat_o = {28'b0,
+			                         {1'b0, bank_valid[sel_blk][0]} + {1'b0, bank_valid[sel_blk][1]},
+			                         fill_busy[sel_blk],
+			                         overflow[sel_blk] | queue_ovf[sel_blk]};
+			REG_BITLEN_HI: wb_dat_o = bitlen_hi[sel_blk];
+			REG_BITLEN_LO: wb_dat_o = bitlen_lo[sel_blk];
+			REG_CTX_SEL:   wb_dat_o = {16'b0, 8'(CTX_SLOTS), 4'b0, view_ctx[sel_blk]};
 
-			// msg_word0[0–15]
+			// msg_word[0–15] (fill bank)
 			8'h04,8'h08,8'h0C,8'h10,8'h14,8'h18,8'h1C,8'h20,
 			8'h24,8'h28,8'h2C,8'h30,8'h34,8'h38,8'h3C,8'h40:
-				wb_dat_o = msg_word0[(wb_addr_i - 8'h04) >> 2];
+				wb_dat_o = VIEW(bank_msg[sel_blk][wr_bank[sel_blk]][(core_off - 8'h04) >> 2], le_view);
 
-			// state_in0[0–7]
+			// state_in[0–7] (fill bank)
 			8'h44,8'h48,8'h4C,8'h50,8'h54,8'h58,8'h5C,8'h60:
-				wb_dat_o = state_in0[(wb_addr_i - 8'h44) >> 2];
+				wb_dat_o = bank_state[sel_blk][wr_bank[sel_blk]][(core_off - 8'h44) >> 2];
 
-			// latched_state_out0[0–7]
+			// state_out[0–7] of the REG_CTX_SEL context
 			8'h64,8'h68,8'h6C,8'h70,8'h74,8'h78,8'h7C,8'h80:
-				wb_dat_o = latched_state_out0[(wb_addr_i - 8'h64) >> 2];
+				wb_dat_o = VIEW(ctx_state[sel_blk][view_ctx[sel_blk]][(core_off - 8'h64) >> 2], le_view);
 		endcase
-	end else begin  // Accessing core 1
-		case (wb_addr_i - ADDR_BASE1)
-			REG_CONTROL: wb_dat_o = control1;
-			REG_STATUS:  wb_dat_o = {31'b0, overflow1};
+	end else if (sel_job) begin  // Accessing the job window
+		case (core_off)
+			REG_CONTROL: wb_dat_o = {!job_res_empty, 7'b0, 8'(job_res_count), 4'b0, job_core, 7'b0, job_pending};
+			REG_BITLEN_HI: wb_dat_o = job_bitlen_hi;
+			REG_BITLEN_LO: wb_dat_o = job_bitlen_lo;
+			REG_JOB_TAG:   wb_dat_o = {24'b0, job_res[263:256]};
 
-			// msg_word1[0–15]
 			8'h04,8'h08,8'h0C,8'h10,8'h14,8'h18,8'h1C,8'h20,
 			8'h24,8'h28,8'h2C,8'h30,8'h34,8'h38,8'h3C,8'h40:
-				wb_dat_o = msg_word1[((wb_addr_i - ADDR_BASE1 - 8'h04) >> 2)];
+				wb_dat_o = VIEW(job_msg[(core_off - 8'h04) >> 2], le_view);
 
-			// state_in1[0–7]
 			8'h44,8'h48,8'h4C,8'h50,8'h54,8'h58,8'h5C,8'h60:
-				wb_dat_o = state_in1[((wb_addr_i - ADDR_BASE1 - 8'h44) >> 2)];
+				wb_dat_o = job_state[(core_off - 8'h44) >> 2];
 
-			// latched_state_out1[0–7]
+			// Oldest tagged completion
 			8'h64,8'h68,8'h6C,8'h70,8'h74,8'h78,8'h7C,8'h80:
-				wb_dat_o = latched_state_out1[((wb_addr_i - ADDR_BASE1 - 8'h64) >> 2)];
+				wb_dat_o = VIEW(job_res[255 - 32*((core_off - 8'h64) >> 2) -: 32], le_view);
+		endcase
+	end else if (sel_pipe) begin  // Accessing the pipelined core window
+		case (core_off)
+			REG_CONTROL: wb_dat_o = {!pipe_res_empty, 7'b0, 8'(pipe_res_count), pipe_res[263:256], 7'b0, pipe_full};
+			REG_STATUS:  wb_dat_o = {31'b0, pipe_overflow};
+
+			8'h04,8'h08,8'h0C,8'h10,8'h14,8'h18,8'h1C,8'h20,
+			8'h24,8'h28,8'h2C,8'h30,8'h34,8'h38,8'h3C,8'h40:
+				wb_dat_o = VIEW(pipe_msg_word[(core_off - 8'h04) >> 2], le_view);
+
+			8'h44,8'h48,8'h4C,8'h50,8'h54,8'h58,8'h5C,8'h60:
+				wb_dat_o = pipe_state_in[(core_off - 8'h44) >> 2];
+
+			// Head result state_out[0–7]
+			8'h64,8'h68,8'h6C,8'h70,8'h74,8'h78,8'h7C,8'h80:
+				wb_dat_o = VIEW(pipe_res[255 - 32*((core_off - 8'h64) >> 2) -: 32], le_view);
+		endcase
+	end else if (sel_hmac) begin  // Accessing an HMAC key slot
+		wb_dat_o = offset[5] ? hmac_opad[offset[7:6]][offset[4:2]] : hmac_ipad[offset[7:6]][offset[4:2]];
+	end else if (sel_perf) begin  // Accessing the performance counters
+		wb_dat_o = perf_dat_o;
+	end else if (sel_global && sel_blk == BLK_INFO) begin  // Accessing core info
+		case (offset)
+			REG_ID:        wb_dat_o = {16'h5348, features, 8'(NUM_CORES)};
+			REG_IDLE_MASK: wb_dat_o = 32'(free_mask);
+			REG_DONE_MASK: wb_dat_o = 32'(done_mask);
+			REG_IRQ_STATUS: wb_dat_o = 32'(irq_status);
+			REG_IRQ_MASK:  wb_dat_o = 32'(irq_mask);
+			REG_CORE_ENABLE: wb_dat_o = 32'(core_en);
 		endcase
 	end
 end
 
 // ----------------------------------
-// WRITE logic and DONE latching
+// WRITE logic, DONE latching and job dispatch
 // ----------------------------------
 always_ff @(posedge clk or posedge wb_rst_i) begin
 	if (wb_rst_i) begin
 		// Clear all registers on reset
-		control0 <= 32'b0;
-		control1 <= 32'b0;
-
-		foreach (msg_word0[i]) msg_word0[i] <= 0;
-		foreach (msg_word1[i]) msg_word1[i] <= 0;
+		foreach (bank_msg[i,b,j]) bank_msg[i][b][j] <= 0;
+		foreach (bank_state[i,b,j]) bank_state[i][b][j] <= 0;
+		foreach (bank_valid[i]) bank_valid[i] <= 2'b00;
+		foreach (bank_chain[i]) bank_chain[i] <= 2'b00;
+		foreach (bank_last[i])  bank_last[i]  <= 2'b00;
+		foreach (bank_ctx[i,b]) bank_ctx[i][b] <= 4'd0;
+		wr_bank   <= '0;
+		rd_bank   <= '0;
+		done_flag <= '0;
+		queue_ovf <= '0;
+		foreach (bitlen_hi[i]) bitlen_hi[i] <= 0;
+		foreach (bitlen_lo[i]) bitlen_lo[i] <= 0;
+		foreach (ctx_blocks[i,c]) ctx_blocks[i][c] <= 0;
+		foreach (view_ctx[i]) view_ctx[i] <= 4'd0;
+		foreach (fin_ctx[i]) fin_ctx[i] <= 4'd0;
+		tail_pending <= '0;
+		outer_pending <= '0;
+		outer_hmac   <= '0;
+		foreach (outer_slot[i]) outer_slot[i] <= 2'd0;
+		foreach (hmac_ipad[i,j]) hmac_ipad[i][j] <= 0;
+		foreach (hmac_opad[i,j]) hmac_opad[i][j] <= 0;
+		irq_status   <= '0;
+		irq_mask     <= '0;
+		core_en      <= '1;
+		foreach (ctx_state[i,c,j]) ctx_state[i][c][j] <= 0;
 
-		foreach (state_in0[i]) state_in0[i] <= 0;
-		foreach (state_in1[i]) state_in1[i] <= 0;
+		foreach (job_msg[i]) job_msg[i] <= 0;
+		foreach (job_state[i]) job_state[i] <= 0;
+		job_pending <= 1'b0;
+		job_core    <= 4'd0;
+		job_bitlen_hi <= 0;
+		job_bitlen_lo <= 0;
+		job_final   <= 1'b0;
+		job_tagged  <= 1'b0;
+		job_nbytes  <= 6'd0;
+		job_tag     <= 8'd0;
+		core_tagged <= '0;
+		foreach (core_tag[i]) core_tag[i] <= 8'd0;
+		res_ready   <= '0;
 
-		foreach (latched_state_out0[i]) latched_state_out0[i] <= 0;
-		foreach (latched_state_out1[i]) latched_state_out1[i] <= 0;
+		foreach (pipe_msg_word[i]) pipe_msg_word[i] <= 0;
+		foreach (pipe_state_in[i]) pipe_state_in[i] <= 0;
+		pipe_in_valid <= 1'b0;
+		pipe_in_tag   <= 8'd0;
+		pipe_used     <= 0;
+		pipe_overflow <= 1'b0;
 
 	end else begin
+		pipe_in_valid <= 1'b0;  // Default: submit pulse lasts one cycle
+
 		// ----------- WRITE TO REGISTERS ------------
 		if (wb_we_i) begin
-			if (sel0) begin  // Core 0
-				case (wb_addr_i)
+			if (sel_core) begin  // Core window
+				case (core_off)
 					REG_CONTROL: begin
-						control0[GO_BIT] <= wb_dat_i[GO_BIT];   // Start signal
-						control0[DONE_BIT] <= 1'b0;             // Clear done flag
+						if (wb_dat_i[GO_BIT]) begin                       // Queue the fill bank
+							if (fill_busy[sel_blk] || go_slot_bad)
+								queue_ovf[sel_blk] <= 1'b1;                 // Both banks busy or no such key slot, drop
+							else begin
+								bank_valid[sel_blk][wr_bank[sel_blk]] <= 1'b1;
+								bank_chain[sel_blk][wr_bank[sel_blk]] <= wb_dat_i[CONT_BIT];
+								bank_last[sel_blk][wr_bank[sel_blk]]  <= !wb_dat_i[CONT_BIT] || wb_dat_i[FINAL_BIT];
+								bank_ctx[sel_blk][wr_bank[sel_blk]]   <= go_ctx;
+								view_ctx[sel_blk] <= go_ctx;                // Readback follows the last GO
+								wr_bank[sel_blk] <= ~wr_bank[sel_blk];
+								ctx_blocks[sel_blk][go_ctx] <= go_blocks + 1'b1;
+								if (wb_dat_i[IPAD_BIT])                     // First inner block of an HMAC
+									bank_state[sel_blk][wr_bank[sel_blk]] <= hmac_ipad[go_slot];
+								if (wb_dat_i[FINAL_BIT]) begin              // Pad the last block
+									bank_msg[sel_blk][wr_bank[sel_blk]] <= pad_msg;
+									bitlen_hi[sel_blk]     <= pad_bitlen[63:32];  // Read by the length block
+									bitlen_lo[sel_blk]     <= pad_bitlen[31:0];
+									tail_pending[sel_blk]  <= pad_need_tail;
+									outer_pending[sel_blk] <= wb_dat_i[DOUBLE_BIT] || wb_dat_i[HMAC_BIT];
+									outer_hmac[sel_blk]    <= wb_dat_i[HMAC_BIT];
+									outer_slot[sel_blk]    <= wb_dat_i[HMAC_BIT] ? go_slot : 2'd0;
+									fin_ctx[sel_blk]       <= go_ctx;
+								end
+							end
+						end
+						done_flag[sel_blk] <= 1'b0;                       // Clear done flag
 					end
-					// msg_word0[0–15]
+
+					REG_STATUS:
+						queue_ovf[sel_blk] <= 1'b0;                       // Any write clears overflow
+
+					REG_BITLEN_HI: bitlen_hi[sel_blk] <= wb_dat_i;
+					REG_BITLEN_LO: bitlen_lo[sel_blk] <= wb_dat_i;
+					REG_CTX_SEL:   view_ctx[sel_blk]  <= wb_dat_i[3:0] & 4'(CTX_SLOTS - 1);
+
+					// msg_word[0–15] (fill bank)
 					8'h04,8'h08,8'h0C,8'h10,8'h14,8'h18,8'h1C,8'h20,
 					8'h24,8'h28,8'h2C,8'h30,8'h34,8'h38,8'h3C,8'h40:
-						msg_word0[(wb_addr_i - 8'h04) >> 2] <= wb_dat_i;
+						bank_msg[sel_blk][wr_bank[sel_blk]][(core_off - 8'h04) >> 2] <= VIEW(wb_dat_i, le_view);
 
-					// state_in0[0–7]
+					// state_in[0–7] (fill bank)
 					8'h44,8'h48,8'h4C,8'h50,8'h54,8'h58,8'h5C,8'h60:
-						state_in0[(wb_addr_i - 8'h44) >> 2] <= wb_dat_i;
+						bank_state[sel_blk][wr_bank[sel_blk]][(core_off - 8'h44) >> 2] <= wb_dat_i;
 				endcase
-			end else begin  // Core 1
-				case (wb_addr_i - ADDR_BASE1)
-					REG_CONTROL: begin
-						control1[GO_BIT] <= wb_dat_i[GO_BIT];
-						control1[DONE_BIT] <= 1'b0;
-					end
-					// msg_word1[0–15]
+			end else if (sel_job) begin  // Job window
+				case (core_off)
+					REG_CONTROL:
+						if (wb_dat_i[GO_BIT]) begin
+							job_pending <= 1'b1;                    // Submit staged job
+							job_final   <= wb_dat_i[FINAL_BIT];
+							job_nbytes  <= wb_dat_i[13:8];
+							job_tagged  <= wb_dat_i[TAGGED_BIT];
+							job_tag     <= wb_dat_i[23:16];
+						end
+					REG_BITLEN_HI: job_bitlen_hi <= wb_dat_i;
+					REG_BITLEN_LO: job_bitlen_lo <= wb_dat_i;
+
+					8'h04,8'h08,8'h0C,8'h10,8'h14,8'h18,8'h1C,8'h20,
+					8'h24,8'h28,8'h2C,8'h30,8'h34,8'h38,8'h3C,8'h40:
+						job_msg[(core_off - 8'h04) >> 2] <= VIEW(wb_dat_i, le_view);
+
+					8'h44,8'h48,8'h4C,8'h50,8'h54,8'h58,8'h5C,8'h60:
+						job_state[(core_off - 8'h44) >> 2] <= wb_dat_i;
+				endcase
+			end else if (sel_pipe) begin  // Pipelined core window
+				case (core_off)
+					REG_CONTROL:
+						if (wb_dat_i[GO_BIT]) begin
+							if (pipe_full)
+								pipe_overflow <= 1'b1;          // No room for the result
+							else begin
+								pipe_in_valid <= 1'b1;
+								pipe_in_tag   <= wb_dat_i[15:8];
+							end
+						end
+
+					REG_STATUS:
+						pipe_overflow <= 1'b0;                  // Any write clears overflow
+
 					8'h04,8'h08,8'h0C,8'h10,8'h14,8'h18,8'h1C,8'h20,
 					8'h24,8'h28,8'h2C,8'h30,8'h34,8'h38,8'h3C,8'h40:
-						msg_word1[((wb_addr_i - ADDR_BASE1 - 8'h04) >> 2)] <= wb_dat_i;
+						pipe_msg_word[(core_off - 8'h04) >> 2] <= VIEW(wb_dat_i, le_view);
 
-					// state_in1[0–7]
 					8'h44,8'h48,8'h4C,8'h50,8'h54,8'h58,8'h5C,8'h60:
-						state_in1[((wb_addr_i - ADDR_BASE1 - 8'h44) >> 2)] <= wb_dat_i;
+						pipe_state_in[(core_off - 8'h44) >> 2] <= wb_dat_i;
+				endcase
+			end else if (sel_hmac) begin  // HMAC key slot
+				if (offset[5])
+					hmac_opad[offset[7:6]][offset[4:2]] <= wb_dat_i;
+				else
+					hmac_ipad[offset[7:6]][offset[4:2]] <= wb_dat_i;
+			end else if (sel_global && sel_blk == BLK_INFO) begin  // Core info
+				case (offset)
+					REG_IRQ_STATUS: irq_status <= irq_status & ~wb_dat_i[IRQ_W-1:0];  // Write 1 to clear
+					REG_IRQ_MASK:   irq_mask   <= wb_dat_i[IRQ_W-1:0];
+					REG_CORE_ENABLE: core_en   <= wb_dat_i[NUM_CORES-1:0];
 				endcase
 			end
 		end
 
+		// ----------- PIPE CREDIT ACCOUNTING ------------
+		// +1 per accepted submission, -1 per popped result
+		pipe_used <= pipe_used
+		           + (wb_we_i && sel_pipe && core_off == REG_CONTROL && wb_dat_i[GO_BIT] && !pipe_full)
+		           - pipe_pop;
+
 		// ----------- LATCH DONE RESULTS ------------
-		if (done0) begin
-			control0[DONE_BIT] <= 1'b1;  // Set done bit
-			control0[GO_BIT] <= 1'b0;    // Clear GO
-			for (int i = 0; i < 8; i++)  // Save result into output registers
-				latched_state_out0[i] <= state_out0[i];
+		for (int i = 0; i < NUM_CORES; i++) begin
+			if (done[i]) begin
+				done_flag[i] <= 1'b1;                   // Set done bit
+				bank_valid[i][rd_bank[i]] <= 1'b0;      // Release the executed bank
+				rd_bank[i] <= ~rd_bank[i];              // Next queued block (if any) starts
+				for (int j = 0; j < 8; j++)             // Save result into the bank's context
+					ctx_state[i][bank_ctx[i][rd_bank[i]]][j] <= state_out[i][j];
+				if (!bank_valid[i][~rd_bank[i]] && !tail_pending[i]) begin
+					if (outer_pending[i]) begin         // Stream done: queue the outer block
+						for (int j = 0; j < 16; j++)
+							bank_msg[i][wr_bank[i]][j] <= (j < 8) ? state_out[i][j] : 32'h0;
+						bank_msg[i][wr_bank[i]][8]  <= 32'h8000_0000;
+						bank_msg[i][wr_bank[i]][15] <= outer_hmac[i] ? 32'd768 : 32'd256;  // (64 +) 32 bytes
+						bank_state[i][wr_bank[i]] <= outer_hmac[i] ? hmac_opad[outer_slot[i]] : SHA256_IV;
+						bank_valid[i][wr_bank[i]] <= 1'b1;
+						bank_chain[i][wr_bank[i]] <= 1'b0;
+						bank_last[i][wr_bank[i]]  <= 1'b1;
+						bank_ctx[i][wr_bank[i]]   <= fin_ctx[i];
+						wr_bank[i] <= ~wr_bank[i];
+						outer_pending[i] <= 1'b0;
+					end else if (core_tagged[i])
+						res_ready[i] <= 1'b1;           // Tagged job: retire into the completion FIFO
+					else if (bank_last[i][rd_bank[i]])
+						irq_status[i] <= 1'b1;          // Stream closed, nothing queued: raise the interrupt
+					// A CONTINUE block that drains before the next one is queued
+					// leaves its stream open: no interrupt for the gap
+				end
+			end
 		end
 
-		if (done1) begin
-			control1[DONE_BIT] <= 1'b1;
-			control1[GO_BIT] <= 1'b0;
-			for (int i = 0; i < 8; i++)
-				latched_state_out1[i] <= state_out1[i];
+		// ----------- QUEUE LENGTH BLOCKS ------------
+		// FINAL block whose bit length did not fit: chain a zero block
+		// ending in BITLEN once the fill bank is free again
+		for (int i = 0; i < NUM_CORES; i++) begin
+			if (tail_pending[i] && !bank_valid[i][wr_bank[i]]) begin
+				for (int j = 0; j < 14; j++)
+					bank_msg[i][wr_bank[i]][j] <= 32'h0;
+				bank_msg[i][wr_bank[i]][14] <= bitlen_hi[i];
+				bank_msg[i][wr_bank[i]][15] <= bitlen_lo[i];
+				bank_valid[i][wr_bank[i]] <= 1'b1;
+				bank_chain[i][wr_bank[i]] <= 1'b1;
+				bank_last[i][wr_bank[i]]  <= 1'b1;
+				bank_ctx[i][wr_bank[i]]   <= fin_ctx[i];
+				wr_bank[i] <= ~wr_bank[i];
+				tail_pending[i] <= 1'b0;
+			end
+		end
+
+		// ----------- RETIRE TAGGED JOBS ------------
+		if (job_res_push) begin
+			res_ready[res_core]   <= 1'b0;
+			core_tagged[res_core] <= 1'b0;
+			done_flag[res_core]   <= 1'b0;    // Core is free for the next job
+		end
+
+		// ----------- ENGINE INTERRUPTS ------------
+		// After the bus write, so an acknowledge in the same cycle keeps the new event
+		for (int e = 0; e < 3; e++)
+			if (engine_done[e]) irq_status[IRQ_ENGINE_LSB + e] <= 1'b1;
+
+		// ----------- DISPATCH STAGED JOB ------------
+		if (job_pending && free_any) begin
+			bank_msg[free_core][wr_bank[free_core]]   <= job_final ? job_pad_msg : job_msg;
+			bank_state[free_core][wr_bank[free_core]] <= job_state;
+			bank_valid[free_core][wr_bank[free_core]] <= 1'b1;
+			bank_chain[free_core][wr_bank[free_core]] <= 1'b0;
+			bank_last[free_core][wr_bank[free_core]]  <= 1'b1;
+			bank_ctx[free_core][wr_bank[free_core]]   <= 4'd0;
+			wr_bank[free_core]   <= ~wr_bank[free_core];
+			done_flag[free_core] <= 1'b0;
+			if (job_final) begin
+				tail_pending[free_core] <= job_pad_need_tail;
+				fin_ctx[free_core]      <= 4'd0;
+				bitlen_hi[free_core]    <= job_bitlen_hi;   // Read by the length block
+				bitlen_lo[free_core]    <= job_bitlen_lo;
+			end
+			core_tagged[free_core] <= job_tagged;
+			core_tag[free_core]    <= job_tag;
+			job_core    <= free_core;
+			job_pending <= 1'b0;
 		end
 	end
 end
@@ -1,10 +1,43 @@
 // =====================================
 // Top-Level SHA256 Accelerator Wrapper
 // - Connects everything: Wishbone bus ↔ Register File ↔ Accelerator Cores
-// - Supports dual-core SHA256 for higher throughput
+// - Generates NUM_CORES SHA256 cores for higher throughput
+// - Address map (byte offsets from the accelerator base 0x80001300):
+//     0x0000 + 0x200*i : core i register window (i < NUM_CORES <= 16)
+//     0x2000           : core info (ID, idle/done masks, interrupt status/mask)
+//     0x2200           : shared job dispatcher window
+//     0x2400           : pipelined core window (PIPE_CORE = 1)
+//     0x2600           : DMA engine (DMA_ENGINE = 1)
+//     0x2800           : nonce sweep engine (NONCE_LANES > 0)
+//     0x2A00           : HMAC key slots (ipad/opad midstates)
+//     0x2C00           : Merkle tree engine (MERKLE_LANES > 0)
+//     0x2E00           : performance counters (PERF_COUNTERS = 1)
+// - CORE_CLK = 1 moves the cores onto core_clk_i; the register file, engines
+//   and bus stay on wb_clk_i
 // =====================================
-module accelerator_top (
+module accelerator_top #(
+	// ------------------------------
+	// Parameters (can be set at compile time)
+	// ------------------------------
+	parameter SIM = 0,
+	parameter debug = 0,
+	parameter NUM_CORES = 2,       // Number of SHA256 cores (1..16)
+	parameter ONLINE_SCHEDULE = 1, // 1: on-the-fly message schedule, 0: precomputed m[0..63]
+	parameter ROUNDS_PER_CYCLE = 1,// Compression rounds per clock (1, 2, 4 or 8)
+	parameter SHARED_K = 0,        // 1: K constants in one block ROM per two cores instead of every core
+	parameter CTX_SLOTS = 4,       // Stream contexts per core (1, 2, 4, 8 or 16), picked by REG_CONTROL[27:24]
+	parameter PIPE_CORE = 0,       // 1: add the 64-stage pipelined core (one block per clock)
+	parameter DMA_ENGINE = 0,      // 1: add the Wishbone-master DMA engine
+	parameter NONCE_LANES = 0,     // >0: add the nonce sweep engine with that many cores
+	parameter MERKLE_LANES = 0,    // >0: add the Merkle tree engine with that many cores
+	parameter MERKLE_LEAVES = 1024,// Leaves the Merkle node buffer holds (power of two)
+	parameter PERF_COUNTERS = 1,   // 1: add the per-core cycle accounting counters
+	parameter CORE_CLK = 0,        // 1: cores run on core_clk_i, async FIFOs to the register file
+	parameter CLOCK_GATE = 0,      // 1: each core's clock goes through a BUFGCE that stops it while idle
+	parameter FAST_WB = 1          // 1: zero-wait writes and burst reads, 0: original 4-state slave
+) (
 	input					wb_clk_i,     // System clock
+	input					core_clk_i,   // Core clock (CORE_CLK = 1), unrelated to wb_clk_i
 
 	// WISHBONE bus interface
 	input	logic			wb_rst_i,     // Reset signal
@@ -14,21 +47,28 @@ module accelerator_top (
 	input	logic			wb_cyc_i,     // Cycle valid signal
 	input	logic	[3:0]	wb_sel_i,     // Byte select (which bytes are active)
 	input	logic			wb_we_i,      // Write enable
-	input	logic	[7:0]	wb_adr_i,     // Address (within accelerator address space)
+	input	logic	[13:0]	wb_adr_i,     // Address (within accelerator address space)
 	input	logic	[31:0]	wb_dat_i,     // Data to write
 	output	logic	[31:0]	wb_dat_o,     // Data to read
 
 	output	logic			wb_ack_o,     // Acknowledge signal
 	output	logic			wb_err_o,     // Error signal
 	output	logic			wb_rty_o,     // Retry signal
-	output	logic			int_o         // Optional interrupt (currently unused)
-);
+	output	logic			int_o,        // Completion interrupt (REG_IRQ_STATUS & REG_IRQ_MASK)
 
-// ------------------------------
-// Parameters (can be set at compile time)
-// ------------------------------
-parameter SIM = 0;
-parameter debug = 0;
+	// WISHBONE master interface (DMA engine and Merkle leaf loader)
+	output	logic			wbm_cyc_o,
+	output	logic			wbm_stb_o,
+	output	logic			wbm_we_o,
+	output	logic	[31:0]	wbm_adr_o,
+	output	logic	[31:0]	wbm_dat_o,
+	output	logic	[3:0]	wbm_sel_o,
+	output	logic	[2:0]	wbm_cti_o,
+	output	logic	[1:0]	wbm_bte_o,
+	input	logic	[31:0]	wbm_dat_i,
+	input	logic			wbm_ack_i,
+	input	logic			wbm_err_i
+);
 
 // ------------------------------
 // Internal Wires
@@ -36,22 +76,58 @@ parameter debug = 0;
 // For data routing between WISHBONE and register file
 logic	[31:0]	wb_data_reg_out;
 logic	[31:0]	wb_data_reg_in;
-logic	[7:0]	wb_adr_int;
+logic	[13:0]	wb_adr_int;
 logic			we_o, re_o;  // Write/read enable for registers
 
-// Accelerator control/status wires
-logic			overflow0, done0;
-logic			overflow1, done1;
-logic	[31:0]	control0, control1;
+// Register file port, shared by the bus and the DMA engine (bus has priority)
+logic	[13:0]	regs_addr;
+logic	[31:0]	regs_dat_i, regs_dat_o;
+logic			regs_we, regs_re;
+
+// DMA engine register block and register master
+logic			sel_dma;
+logic	[31:0]	dma_dat_o;
+
+// Nonce sweep engine register block
+logic			sel_nonce;
+logic	[31:0]	nonce_dat_o;
+
+// Merkle tree engine register block
+logic			sel_merkle;
+logic	[31:0]	merkle_dat_o;
+
+// Wishbone masters behind wbm_*: [0] = DMA engine, [1] = Merkle leaf loader
+logic	[1:0]	m_cyc, m_stb, m_we;
+logic	[31:0]	m_adr [0:1];
+logic	[31:0]	m_dat [0:1];
+logic	[3:0]	m_sel [0:1];
+logic	[2:0]	m_cti [0:1];
+logic	[1:0]	m_bte [0:1];
+logic			wbm_owner;
+logic			dma_rm_req, dma_rm_we, dma_rm_gnt;
+logic	[13:0]	dma_rm_addr;
+logic	[31:0]	dma_rm_wdata;
+
+// Accelerator control/status wires, one entry per core
+logic	[NUM_CORES-1:0]	overflow, done;
+logic	[31:0]	control   [0:NUM_CORES-1];
 
 // Accelerator input and output buffers for each core
-logic	[31:0]	msg_word0  [0:15];
-logic	[31:0]	state_in0  [0:7];
-logic	[31:0]	state_out0 [0:7];
+logic	[31:0]	msg_word  [0:NUM_CORES-1][0:15];
+logic	[31:0]	state_in  [0:NUM_CORES-1][0:7];
+logic	[31:0]	state_out [0:NUM_CORES-1][0:7];
+logic	[2:0]	core_state [0:NUM_CORES-1];
+logic	[NUM_CORES-1:0]	core_en;
+logic			dma_done, nonce_done, merkle_done;  // Engine interrupts (REG_IRQ_STATUS [18:16])
+logic	[5:0]	k_addr    [0:NUM_CORES-1];
+logic	[31:0]	k_word    [0:NUM_CORES-1][0:ROUNDS_PER_CYCLE-1];
 
-logic	[31:0]	msg_word1  [0:15];
-logic	[31:0]	state_in1  [0:7];
-logic	[31:0]	state_out1 [0:7];
+// Pipelined core interface
+logic			pipe_in_valid, pipe_out_valid;
+logic	[7:0]	pipe_in_tag, pipe_out_tag;
+logic	[31:0]	pipe_msg_word  [0:15];
+logic	[31:0]	pipe_state_in  [0:7];
+logic	[31:0]	pipe_state_out [0:7];
 
 // ------------------------------
 // Optional: Include ILA for Debug (only in debug builds)
@@ -61,13 +137,13 @@ ila_accelerator ila_accelerator (
 	.clk(wb_clk_i),
 	.probe0(we_o),
 	.probe1(re_o),
-	.probe2(control0),
-	.probe3(msg_word0[0]),
-	.probe4(state_in0[0]),
-	.probe5(state_out0[0]),
-	.probe6(control1),
-	.probe7(msg_word1[0]),
-	.probe8({31'b0, overflow0 | overflow1})
+	.probe2(control[0]),
+	.probe3(msg_word[0][0]),
+	.probe4(state_in[0][0]),
+	.probe5(state_out[0][0]),
+	.probe6(control[NUM_CORES-1]),
+	.probe7(msg_word[NUM_CORES-1][0]),
+	.probe8({31'b0, |overflow})
 );
 `endif
 
@@ -75,92 +151,357 @@ ila_accelerator ila_accelerator (
 // WISHBONE to Register Bridge
 // ------------------------------
 // This module handles bus protocol and simplifies register reads/writes
-accelerator_wb wb_interface (
-	.clk				(wb_clk_i),
-	.wb_rst_i			(wb_rst_i),
-	.wb_we_i			(wb_we_i),
-	.wb_stb_i			(wb_stb_i),
-	.wb_cti_i			(wb_cti_i),
-	.wb_bte_i			(wb_bte_i),
-	.wb_cyc_i			(wb_cyc_i),
-	.wb_ack_o			(wb_ack_o),
-	.wb_sel_i			(wb_sel_i),
-	.wb_adr_i			(wb_adr_i),
-	.wb_dat_i			(wb_dat_i),
-	.wb_dat_o			(wb_dat_o),
-	.wb_err_o			(wb_err_o),
-	.wb_rty_o			(wb_rty_o),
-	.wb_adr_reg			(wb_adr_int),
-	.wb_data_reg_in		(wb_data_reg_in),
-	.wb_data_reg_out	(wb_data_reg_out),
-	.we_o				(we_o),
-	.re_o				(re_o)
-);
+if (FAST_WB) begin : g_wb_fast
+	accelerator_wb_fast wb_interface (
+		.clk				(wb_clk_i),
+		.wb_rst_i			(wb_rst_i),
+		.wb_we_i			(wb_we_i),
+		.wb_stb_i			(wb_stb_i),
+		.wb_cti_i			(wb_cti_i),
+		.wb_bte_i			(wb_bte_i),
+		.wb_cyc_i			(wb_cyc_i),
+		.wb_ack_o			(wb_ack_o),
+		.wb_sel_i			(wb_sel_i),
+		.wb_adr_i			(wb_adr_i),
+		.wb_dat_i			(wb_dat_i),
+		.wb_dat_o			(wb_dat_o),
+		.wb_err_o			(wb_err_o),
+		.wb_rty_o			(wb_rty_o),
+		.wb_adr_reg			(wb_adr_int),
+		.wb_data_reg_in		(wb_data_reg_in),
+		.wb_data_reg_out	(wb_data_reg_out),
+		.we_o				(we_o),
+		.re_o				(re_o)
+	);
+end else begin : g_wb
+	accelerator_wb wb_interface (
+		.clk				(wb_clk_i),
+		.wb_rst_i			(wb_rst_i),
+		.wb_we_i			(wb_we_i),
+		.wb_stb_i			(wb_stb_i),
+		.wb_cti_i			(wb_cti_i),
+		.wb_bte_i			(wb_bte_i),
+		.wb_cyc_i			(wb_cyc_i),
+		.wb_ack_o			(wb_ack_o),
+		.wb_sel_i			(wb_sel_i),
+		.wb_adr_i			(wb_adr_i),
+		.wb_dat_i			(wb_dat_i),
+		.wb_dat_o			(wb_dat_o),
+		.wb_err_o			(wb_err_o),
+		.wb_rty_o			(wb_rty_o),
+		.wb_adr_reg			(wb_adr_int),
+		.wb_data_reg_in		(wb_data_reg_in),
+		.wb_data_reg_out	(wb_data_reg_out),
+		.we_o				(we_o),
+		.re_o				(re_o)
+	);
+end
+
+// ------------------------------
+// Register port arbitration
+// Bus accesses go straight through; the DMA engine gets the port in
+// cycles where the bus is not reading or writing a register
+// ------------------------------
+assign sel_dma    = (DMA_ENGINE != 0) && wb_adr_int[13] && (wb_adr_int[12:9] == 4'h3);
+assign sel_nonce  = (NONCE_LANES != 0) && wb_adr_int[13] && (wb_adr_int[12:9] == 4'h4);
+assign sel_merkle = (MERKLE_LANES != 0) && wb_adr_int[13] && (wb_adr_int[12:9] == 4'h6);
+assign dma_rm_gnt = dma_rm_req && !(we_o || re_o);
+
+assign regs_addr  = dma_rm_gnt ? dma_rm_addr  : wb_adr_int;
+assign regs_dat_i = dma_rm_gnt ? dma_rm_wdata : wb_data_reg_out;
+assign regs_we    = dma_rm_gnt ? dma_rm_we    : (we_o && !sel_dma && !sel_nonce && !sel_merkle);
+assign regs_re    = dma_rm_gnt ? !dma_rm_we   : (re_o && !sel_dma && !sel_nonce && !sel_merkle);
+
+assign wb_data_reg_in = sel_dma ? dma_dat_o : sel_nonce ? nonce_dat_o : sel_merkle ? merkle_dat_o : regs_dat_o;
+
+// ------------------------------
+// Wishbone master arbitration
+// The owner keeps wbm_* until it drops cyc; the DMA engine wins ties
+// ------------------------------
+always_ff @(posedge wb_clk_i or posedge wb_rst_i)
+	if (wb_rst_i)
+		wbm_owner <= 1'b0;
+	else if (!m_cyc[wbm_owner])
+		wbm_owner <= !m_cyc[0] && m_cyc[1];
+
+assign wbm_cyc_o = m_cyc[wbm_owner];
+assign wbm_stb_o = m_stb[wbm_owner];
+assign wbm_we_o  = m_we[wbm_owner];
+assign wbm_adr_o = m_adr[wbm_owner];
+assign wbm_dat_o = m_dat[wbm_owner];
+assign wbm_sel_o = m_sel[wbm_owner];
+assign wbm_cti_o = m_cti[wbm_owner];
+assign wbm_bte_o = m_bte[wbm_owner];
 
 // ------------------------------
 // Register File (accessible by WISHBONE)
 // Handles writing to accelerator inputs and reading results
 // ------------------------------
-accelerator_regs regs (
+accelerator_regs #(
+	.SIM		(SIM),
+	.NUM_CORES	(NUM_CORES),
+	.PIPE_CORE	(PIPE_CORE),
+	.CTX_SLOTS	(CTX_SLOTS),
+	.PERF_COUNTERS	(PERF_COUNTERS),
+	.EXT_FEATURES	(8'((DMA_ENGINE != 0) << 1) | 8'((NONCE_LANES != 0) << 2) | 8'((MERKLE_LANES != 0) << 4))
+) regs (
 	.clk		(wb_clk_i),
 	.wb_rst_i	(wb_rst_i),
-	.wb_addr_i	(wb_adr_int),
-	.wb_dat_i	(wb_data_reg_out),
-	.wb_dat_o	(wb_data_reg_in),
-	.wb_we_i	(we_o),
-	.wb_re_i	(re_o),
-
-	// Accelerator 0
-	.control0	(control0),
-	.done0		(done0),
-	.overflow0	(overflow0),
-	.msg_word0	(msg_word0),
-	.state_in0	(state_in0),
-	.state_out0	(state_out0),
-
-	// Accelerator 1
-	.control1	(control1),
-	.done1		(done1),
-	.overflow1	(overflow1),
-	.msg_word1	(msg_word1),
-	.state_in1	(state_in1),
-	.state_out1	(state_out1)
+	.wb_addr_i	(regs_addr),
+	.wb_dat_i	(regs_dat_i),
+	.wb_dat_o	(regs_dat_o),
+	.wb_we_i	(regs_we),
+	.wb_re_i	(regs_re),
+
+	.control	(control),
+	.done		(done),
+	.overflow	(overflow),
+	.msg_word	(msg_word),
+	.state_in	(state_in),
+	.state_out	(state_out),
+	.core_state	(core_state),
+	.core_en	(core_en),
+
+	.pipe_in_valid	(pipe_in_valid),
+	.pipe_in_tag	(pipe_in_tag),
+	.pipe_msg_word	(pipe_msg_word),
+	.pipe_state_in	(pipe_state_in),
+	.pipe_out_valid	(pipe_out_valid),
+	.pipe_out_tag	(pipe_out_tag),
+	.pipe_state_out	(pipe_state_out),
+
+	.engine_done	({merkle_done, nonce_done, dma_done}),
+	.irq		(int_o)
 );
 
 // ------------------------------
-// Accelerator Core 0
-// Processes SHA256 for messages using its own buffer
+// Accelerator Cores
+// Each core processes SHA256 blocks from its own register window
+// With CORE_CLK = 1 each core sits behind accelerator_cdc and hashes on core_clk_i
 // ------------------------------
-accelerator accelerator0 (
-	.clk		(wb_clk_i),
-	.wb_rst_i	(wb_rst_i),
-	.control	(control0),
-	.done		(done0),
-	.overflow	(overflow0),
-	.msg_word	(msg_word0),
-	.state_in	(state_in0),
-	.state_out	(state_out0)
-);
+wire core_clk = CORE_CLK ? core_clk_i : wb_clk_i;   // Clock of the cores and the K ROM
+
+for (genvar i = 0; i < NUM_CORES; i++) begin : g_core
+	if (CORE_CLK) begin : g_cdc
+		accelerator_cdc #(
+			.ONLINE_SCHEDULE	(ONLINE_SCHEDULE),
+			.ROUNDS_PER_CYCLE	(ROUNDS_PER_CYCLE),
+			.SHARED_K			(SHARED_K),
+			.CLOCK_GATE			(CLOCK_GATE)
+		) accelerator (
+			.clk		(wb_clk_i),
+			.wb_rst_i	(wb_rst_i),
+			.core_clk	(core_clk_i),
+			.enable		(core_en[i]),
+			.control	(control[i]),
+			.done		(done[i]),
+			.overflow	(overflow[i]),
+			.msg_word	(msg_word[i]),
+			.state_in	(state_in[i]),
+			.state_out	(state_out[i]),
+			.fsm_state	(core_state[i]),
+			.k_addr		(k_addr[i]),
+			.k_word		(k_word[i])
+		);
+	end else begin : g_sync
+		accelerator #(
+			.ONLINE_SCHEDULE	(ONLINE_SCHEDULE),
+			.ROUNDS_PER_CYCLE	(ROUNDS_PER_CYCLE),
+			.SHARED_K			(SHARED_K),
+			.CLOCK_GATE			(CLOCK_GATE)
+		) accelerator (
+			.clk		(wb_clk_i),
+			.wb_rst_i	(wb_rst_i),
+			.enable		(core_en[i]),
+			.control	(control[i]),
+			.done		(done[i]),
+			.overflow	(overflow[i]),
+			.msg_word	(msg_word[i]),
+			.state_in	(state_in[i]),
+			.state_out	(state_out[i]),
+			.fsm_state	(core_state[i]),
+			.k_addr		(k_addr[i]),
+			.k_word		(k_word[i])
+		);
+	end
+end
 
 // ------------------------------
-// Accelerator Core 1
-// Identical to Core 0 but can be used in parallel for performance
+// Optional: Shared K ROM
+// Cores run out of step, so each has a read port; two ports share a block RAM
 // ------------------------------
-accelerator accelerator1 (
-	.clk		(wb_clk_i),
-	.wb_rst_i	(wb_rst_i),
-	.control	(control1),
-	.done		(done1),
-	.overflow	(overflow1),
-	.msg_word	(msg_word1),
-	.state_in	(state_in1),
-	.state_out	(state_out1)
-);
+if (SHARED_K) begin : g_krom
+	accelerator_krom #(
+		.PORTS				(NUM_CORES),
+		.ROUNDS_PER_CYCLE	(ROUNDS_PER_CYCLE),
+		.ROM_STYLE			("block")
+	) krom (
+		.clk		(core_clk),
+		.addr		(k_addr),
+		.k_word		(k_word)
+	);
+end else begin : g_no_krom
+	for (genvar i = 0; i < NUM_CORES; i++) begin : g_tie
+		for (genvar r = 0; r < ROUNDS_PER_CYCLE; r++) begin : g_word
+			assign k_word[i][r] = 32'h0;
+		end
+	end
+end
+
+// ------------------------------
+// Optional: Pipelined Core
+// One round per stage, takes a new tagged block every clock
+// ------------------------------
+if (PIPE_CORE) begin : g_pipe
+	accelerator_pipe #(
+		.TAG_W		(8)
+	) accelerator_pipe (
+		.clk		(wb_clk_i),
+		.wb_rst_i	(wb_rst_i),
+		.in_valid	(pipe_in_valid),
+		.in_tag		(pipe_in_tag),
+		.msg_word	(pipe_msg_word),
+		.state_in	(pipe_state_in),
+		.out_valid	(pipe_out_valid),
+		.out_tag	(pipe_out_tag),
+		.state_out	(pipe_state_out)
+	);
+end else begin : g_no_pipe
+	assign pipe_out_valid = 1'b0;
+	assign pipe_out_tag   = 8'd0;
+	for (genvar i = 0; i < 8; i++) begin : g_tie
+		assign pipe_state_out[i] = 32'h0;
+	end
+end
+
+// ------------------------------
+// Optional: DMA Engine
+// Fetches a message from memory, hashes it on one core, stores the digest
+// ------------------------------
+if (DMA_ENGINE) begin : g_dma
+	accelerator_dma #(
+		.NUM_CORES	(NUM_CORES)
+	) dma (
+		.clk		(wb_clk_i),
+		.wb_rst_i	(wb_rst_i),
+
+		.reg_sel	(sel_dma),
+		.reg_addr	(wb_adr_int[8:0]),
+		.reg_dat_i	(wb_data_reg_out),
+		.reg_dat_o	(dma_dat_o),
+		.reg_we		(we_o),
+
+		.rm_req		(dma_rm_req),
+		.rm_we		(dma_rm_we),
+		.rm_addr	(dma_rm_addr),
+		.rm_wdata	(dma_rm_wdata),
+		.rm_gnt		(dma_rm_gnt),
+		.rm_rdata	(regs_dat_o),
+
+		.wbm_cyc_o	(m_cyc[0]),
+		.wbm_stb_o	(m_stb[0]),
+		.wbm_we_o	(m_we[0]),
+		.wbm_adr_o	(m_adr[0]),
+		.wbm_dat_o	(m_dat[0]),
+		.wbm_sel_o	(m_sel[0]),
+		.wbm_cti_o	(m_cti[0]),
+		.wbm_bte_o	(m_bte[0]),
+		.wbm_dat_i	(wbm_dat_i),
+		.wbm_ack_i	(wbm_ack_i && wbm_owner == 1'b0),
+		.wbm_err_i	(wbm_err_i && wbm_owner == 1'b0),
+
+		.done_o		(dma_done)
+	);
+end else begin : g_no_dma
+	assign dma_done     = 1'b0;
+	assign dma_dat_o    = 32'h0;
+	assign dma_rm_req   = 1'b0;
+	assign dma_rm_we    = 1'b0;
+	assign dma_rm_addr  = 14'h0;
+	assign dma_rm_wdata = 32'h0;
+
+	assign m_cyc[0] = 1'b0;
+	assign m_stb[0] = 1'b0;
+	assign m_we[0]  = 1'b0;
+	assign m_adr[0] = 32'h0;
+	assign m_dat[0] = 32'h0;
+	assign m_sel[0] = 4'h0;
+	assign m_cti[0] = 3'b000;
+	assign m_bte[0] = 2'b00;
+end
+
+// ------------------------------
+// Optional: Nonce Sweep Engine
+// Dedicated cores that sweep a nonce range over a fixed midstate
+// ------------------------------
+if (NONCE_LANES) begin : g_nonce
+	accelerator_nonce #(
+		.LANES				(NONCE_LANES),
+		.ONLINE_SCHEDULE	(ONLINE_SCHEDULE),
+		.ROUNDS_PER_CYCLE	(ROUNDS_PER_CYCLE)
+	) nonce (
+		.clk		(wb_clk_i),
+		.wb_rst_i	(wb_rst_i),
+
+		.reg_sel	(sel_nonce),
+		.reg_addr	(wb_adr_int[8:0]),
+		.reg_dat_i	(wb_data_reg_out),
+		.reg_dat_o	(nonce_dat_o),
+		.reg_we		(we_o),
+
+		.done_o		(nonce_done)
+	);
+end else begin : g_no_nonce
+	assign nonce_dat_o = 32'h0;
+	assign nonce_done  = 1'b0;
+end
 
 // ------------------------------
-// Optional: Interrupt line (not used for now)
-// Can be extended to int_o = done0 | done1 for interrupt-based polling
+// Optional: Merkle Tree Engine
+// Dedicated cores that reduce a leaf buffer to the root and auth path
 // ------------------------------
-assign int_o = 1'b0;
+if (MERKLE_LANES) begin : g_merkle
+	accelerator_merkle #(
+		.LANES				(MERKLE_LANES),
+		.ONLINE_SCHEDULE	(ONLINE_SCHEDULE),
+		.ROUNDS_PER_CYCLE	(ROUNDS_PER_CYCLE),
+		.MAX_LEAVES			(MERKLE_LEAVES)
+	) merkle (
+		.clk		(wb_clk_i),
+		.wb_rst_i	(wb_rst_i),
+
+		.reg_sel	(sel_merkle),
+		.reg_addr	(wb_adr_int[8:0]),
+		.reg_dat_i	(wb_data_reg_out),
+		.reg_dat_o	(merkle_dat_o),
+		.reg_we		(we_o),
+
+		.wbm_cyc_o	(m_cyc[1]),
+		.wbm_stb_o	(m_stb[1]),
+		.wbm_we_o	(m_we[1]),
+		.wbm_adr_o	(m_adr[1]),
+		.wbm_dat_o	(m_dat[1]),
+		.wbm_sel_o	(m_sel[1]),
+		.wbm_cti_o	(m_cti[1]),
+		.wbm_bte_o	(m_bte[1]),
+		.wbm_dat_i	(wbm_dat_i),
+		.wbm_ack_i	(wbm_ack_i && wbm_owner == 1'b1),
+		.wbm_err_i	(wbm_err_i && wbm_owner == 1'b1),
+
+		.done_o		(merkle_done)
+	);
+end else begin : g_no_merkle
+	assign merkle_dat_o = 32'h0;
+	assign merkle_done  = 1'b0;
+
+	assign m_cyc[1] = 1'b0;
+	assign m_stb[1] = 1'b0;
+	assign m_we[1]  = 1'b0;
+	assign m_adr[1] = 32'h0;
+	assign m_dat[1] = 32'h0;
+	assign m_sel[1] = 4'h0;
+	assign m_cti[1] = 3'b000;
+	assign m_bte[1] = 2'b00;
+end
 
 endmodule
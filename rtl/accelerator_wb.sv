@@ -147,13 +147,13 @@ module accelerator_wb (
 	input	logic			wb_cyc_i, 
 	output	logic			wb_ack_o, 
 	input	logic	[3:0]	wb_sel_i,
-	input	logic	[7:0]	wb_adr_i,	//WISHBONE address line
+	input	logic	[13:0]	wb_adr_i,	//WISHBONE address line
 	input	logic	[31:0]	wb_dat_i,   //input WISHBONE bus 
 	output	logic	[31:0]	wb_dat_o, 
 	output	logic			wb_err_o,
 	output	logic			wb_rty_o,	
 	
-	output	logic	[7:0]	wb_adr_reg,  // internal signal for address bus
+	output	logic	[13:0]	wb_adr_reg,  // internal signal for address bus
 	input	logic	[31:0]	wb_data_reg_in, 
 	output	logic	[31:0]	wb_data_reg_out,
 	output	logic			we_o, 
@@ -163,7 +163,7 @@ module accelerator_wb (
 
 
 
-logic	[7:0]	wb_adr_is;
+logic	[13:0]	wb_adr_is;
 logic			wb_we_is;
 logic			wb_cyc_is;
 logic			wb_stb_is;
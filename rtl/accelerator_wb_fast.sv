@@ -0,0 +1,78 @@
+// =====================================
+// Low-latency WISHBONE Slave for the Accelerator Register File
+// - Same register-side ports as accelerator_wb, selected by FAST_WB in accelerator_top
+// - Writes are acked in the cycle they are presented (zero wait states)
+// - Reads are registered: classic cycles take two clocks, registered-feedback
+//   incrementing bursts (CTI = 3'b010, linear or wrapped BTE) return one word
+//   per clock by reading the next beat's address while the current beat is acked
+// - Register reads have no side effects, so a prefetched beat that the master
+//   does not take is simply dropped
+// =====================================
+module accelerator_wb_fast (
+	input	logic			clk,
+	input	logic			wb_rst_i,
+
+	// WISHBONE slave
+	input	logic			wb_we_i,
+	input	logic			wb_stb_i,
+	input	logic	[2:0]	wb_cti_i,
+	input	logic	[1:0]	wb_bte_i,
+	input	logic			wb_cyc_i,
+	output	logic			wb_ack_o,
+	input	logic	[3:0]	wb_sel_i,
+	input	logic	[13:0]	wb_adr_i,
+	input	logic	[31:0]	wb_dat_i,
+	output	logic	[31:0]	wb_dat_o,
+	output	logic			wb_err_o,
+	output	logic			wb_rty_o,
+
+	// Register file side
+	output	logic	[13:0]	wb_adr_reg,       // Register address of this cycle's access
+	input	logic	[31:0]	wb_data_reg_in,   // Read data for wb_adr_reg
+	output	logic	[31:0]	wb_data_reg_out,  // Write data
+	output	logic			we_o,             // Register write this cycle
+	output	logic			re_o              // Register read this cycle
+);
+
+localparam CTI_INC_BURST = 3'b010;
+
+// Address of the beat after adr in an incrementing burst
+function logic [13:0] NEXT_ADR(input logic [13:0] adr, input logic [1:0] bte);
+	case (bte)
+		2'b01:   return {adr[13:4], adr[3:2] + 2'd1, adr[1:0]};   // 4-beat wrap
+		2'b10:   return {adr[13:5], adr[4:2] + 3'd1, adr[1:0]};   // 8-beat wrap
+		2'b11:   return {adr[13:6], adr[5:2] + 4'd1, adr[1:0]};   // 16-beat wrap
+		default: return adr + 14'd4;                              // Linear
+	endcase
+endfunction
+
+logic	rd_ack;   // Read data for the current beat is in wb_dat_o
+
+wire valid      = wb_cyc_i && wb_stb_i;
+wire rd_next    = rd_ack && (wb_cti_i == CTI_INC_BURST);   // Current beat acked, another follows
+
+assign wb_err_o = 1'b0;
+assign wb_rty_o = 1'b0;
+
+assign we_o = valid && wb_we_i;
+assign re_o = valid && !wb_we_i && (!rd_ack || rd_next);
+
+assign wb_adr_reg      = rd_next ? NEXT_ADR(wb_adr_i, wb_bte_i) : wb_adr_i;
+assign wb_data_reg_out = wb_dat_i;
+
+// Gated by stb so a burst the master pauses never sees a stale ack
+assign wb_ack_o = we_o || (valid && !wb_we_i && rd_ack);
+
+always_ff @(posedge clk or posedge wb_rst_i)
+	if (wb_rst_i)
+		rd_ack <= 1'b0;
+	else
+		rd_ack <= re_o;
+
+always_ff @(posedge clk or posedge wb_rst_i)
+	if (wb_rst_i)
+		wb_dat_o <= 32'h0;
+	else if (re_o)
+		wb_dat_o <= wb_data_reg_in;
+
+endmodule
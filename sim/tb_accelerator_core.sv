@@ -20,12 +20,16 @@ module tb_accelerator_core;
   accelerator dut (
     .clk(clk),
     .wb_rst_i(rst),
+    .enable(1'b1),
     .control(control),
     .done(done),
     .overflow(overflow),
     .msg_word(msg_word),
     .state_in(state_in),
-    .state_out(state_out)
+    .state_out(state_out),
+    .fsm_state(),
+    .k_addr(),
+    .k_word()
   );
 
   localparam logic [31:0] SHA256_INIT_STATE [0:7] = '{
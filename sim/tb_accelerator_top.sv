@@ -0,0 +1,696 @@
+`timescale 1ns/1ps
+
+// Self-checking testbench for accelerator_top at the Wishbone level
+// - NIST FIPS 180-2 vectors on every core, then randomized multi-block messages
+//   hashed on all cores at once, checked against a reference model
+// - Measures single-block latency, cycles per block and bus utilization
+// - Covers the register-file features: AUTO_LEN at the padding edges, the job
+//   dispatcher with tagged completions, SHA256d and HMAC key slots, and (with
+//   FAST_WB) incrementing bursts against classic cycles
+// - Runs the DMA engine and the pipelined core when they are built in
+// - Holds a core off with REG_CORE_ENABLE, before GO and in the middle of a
+//   block, and checks the block only finishes once it is enabled again (run
+//   it with SHARED_K=1 too: the K ROM keeps its clock while the core is parked)
+// - Ends with $fatal on any mismatch, or when the run exceeds the WATCHDOG
+//   cycle limit (a missing ack or DONE), so it can gate a regression run
+// Override the DUT parameters from the simulator, e.g. xelab -generic_top "ROUNDS_PER_CYCLE=4"
+module tb_accelerator_top;
+
+  parameter NUM_CORES        = 2;
+  parameter ONLINE_SCHEDULE  = 1;
+  parameter ROUNDS_PER_CYCLE = 1;
+  parameter SHARED_K         = 0;
+  parameter CTX_SLOTS        = 4;
+  parameter PIPE_CORE        = 0;
+  parameter DMA_ENGINE       = 0;
+  parameter PERF_COUNTERS    = 1;
+  parameter FAST_WB          = 1;
+  parameter CORE_CLK         = 0;
+  parameter real CORE_HALF_NS = 3.1;  // CORE_CLK = 1: core clock half period (bus: 5 ns)
+  parameter CLOCK_GATE       = 0;     // 1: needs the UNISIM BUFGCE model
+  parameter RAND_MSGS        = 8;     // Random messages per core
+  parameter RAND_MAX_LEN     = 300;   // Bytes
+  parameter LONG_VECTORS     = 0;     // 1: add the 1,000,000 x 'a' vector (15,625 blocks)
+  parameter SEED             = 1;
+  parameter WATCHDOG         = 0;     // Cycle limit for the whole run; 0: 2M cycles (40M with LONG_VECTORS)
+
+  // Register offsets (see accelerator_regs)
+  localparam REG_CONTROL    = 14'h000;
+  localparam REG_MSG_BASE   = 14'h004;
+  localparam REG_STATE_IN   = 14'h044;
+  localparam REG_STATE_OUT  = 14'h064;
+  localparam REG_STATUS     = 14'h084;
+  localparam REG_BITLEN_HI  = 14'h088;
+  localparam REG_BITLEN_LO  = 14'h08C;
+  localparam REG_CTX_SEL    = 14'h090;
+  localparam REG_ID         = 14'h2000;
+  localparam REG_CORE_EN    = 14'h2014;
+  localparam REG_JOB_BASE   = 14'h2200;
+  localparam REG_JOB_TAG    = 14'h2290;
+  localparam REG_JOB_POP    = 14'h2294;
+  localparam REG_HMAC_BASE  = 14'h2A00;  // Slot s: ipad state at +0x40*s, opad state at +0x20
+  localparam REG_PIPE_BASE  = 14'h2400;
+  localparam REG_PIPE_POP   = 14'h2488;
+  localparam REG_DMA_BASE   = 14'h2600;
+  localparam REG_PERF_BASE  = 14'h2E00;
+
+  localparam CTRL_GO        = 32'h0000_0001;
+  localparam CTRL_CONTINUE  = 32'h0000_0002;
+  localparam CTRL_FINAL     = 32'h0000_0004;
+  localparam CTRL_DOUBLE    = 32'h0000_0008;
+  localparam CTRL_HMAC      = 32'h0000_0010;
+  localparam CTRL_IPAD      = 32'h0000_0020;
+  localparam CTRL_AUTO_LEN  = 32'h0000_0040;
+  localparam JOB_TAGGED     = 32'h0000_0080;
+  localparam JOB_PENDING    = 32'h0000_0001;
+  localparam JOB_RESULT     = 32'h8000_0000;
+  localparam SLOT_LSB       = 16;
+  localparam CTI_CLASSIC    = 3'b000;
+  localparam CTI_INC_BURST  = 3'b010;
+  localparam CTI_END        = 3'b111;
+  localparam CTX_LSB        = 24;
+  localparam CTRL_BUSY      = 32'h0000_0001;
+  localparam CTRL_DONE      = 32'h8000_0000;
+  localparam STATUS_FULL    = 32'h0000_0002;
+
+  localparam MEM_WORDS      = 16384;  // 64 KB behind the Wishbone master port
+  localparam DMA_SRC        = 32'h0000_1000;
+  localparam DMA_DST        = 32'h0000_F000;
+
+  // ---- Reference model (IV, K, compression, padding) ----
+  `include "sha256_ref.svh"
+
+  // ---- DUT ----
+  logic        clk, core_clk, rst;
+  logic        wb_stb, wb_cyc, wb_we;
+  logic [2:0]  wb_cti;
+  logic [1:0]  wb_bte;
+  logic [3:0]  wb_sel;
+  logic [13:0] wb_adr;
+  logic [31:0] wb_wdat, wb_rdat;
+  logic        wb_ack, wb_err, wb_rty, irq;
+
+  logic        wbm_cyc, wbm_stb, wbm_we, wbm_ack;
+  logic [31:0] wbm_adr, wbm_wdat, wbm_rdat;
+  logic [3:0]  wbm_sel;
+  logic [2:0]  wbm_cti;
+  logic [1:0]  wbm_bte;
+
+  always #5 clk = ~clk;
+  always #(CORE_HALF_NS) core_clk = ~core_clk;
+
+  accelerator_top #(
+    .NUM_CORES        (NUM_CORES),
+    .ONLINE_SCHEDULE  (ONLINE_SCHEDULE),
+    .ROUNDS_PER_CYCLE (ROUNDS_PER_CYCLE),
+    .SHARED_K         (SHARED_K),
+    .CTX_SLOTS        (CTX_SLOTS),
+    .PIPE_CORE        (PIPE_CORE),
+    .DMA_ENGINE       (DMA_ENGINE),
+    .PERF_COUNTERS    (PERF_COUNTERS),
+    .FAST_WB          (FAST_WB),
+    .CORE_CLK         (CORE_CLK),
+    .CLOCK_GATE       (CLOCK_GATE)
+  ) dut (
+    .wb_clk_i  (clk),
+    .core_clk_i(core_clk),
+    .wb_rst_i  (rst),
+    .wb_stb_i  (wb_stb),
+    .wb_cti_i  (wb_cti),
+    .wb_bte_i  (wb_bte),
+    .wb_cyc_i  (wb_cyc),
+    .wb_sel_i  (wb_sel),
+    .wb_we_i   (wb_we),
+    .wb_adr_i  (wb_adr),
+    .wb_dat_i  (wb_wdat),
+    .wb_dat_o  (wb_rdat),
+    .wb_ack_o  (wb_ack),
+    .wb_err_o  (wb_err),
+    .wb_rty_o  (wb_rty),
+    .int_o     (irq),
+
+    .wbm_cyc_o (wbm_cyc),
+    .wbm_stb_o (wbm_stb),
+    .wbm_we_o  (wbm_we),
+    .wbm_adr_o (wbm_adr),
+    .wbm_dat_o (wbm_wdat),
+    .wbm_sel_o (wbm_sel),
+    .wbm_cti_o (wbm_cti),
+    .wbm_bte_o (wbm_bte),
+    .wbm_dat_i (wbm_rdat),
+    .wbm_ack_i (wbm_ack),
+    .wbm_err_i (1'b0)
+  );
+
+  // ---- Memory behind the Wishbone master port (little-endian, one wait state) ----
+  logic [31:0] mem [0:MEM_WORDS-1];
+
+  // Plain always: the DMA test also preloads and reads mem from the initial block
+  always @(posedge clk) begin
+    wbm_ack <= 1'b0;
+    if (wbm_cyc && wbm_stb && !wbm_ack) begin
+      wbm_ack  <= 1'b1;
+      wbm_rdat <= mem[wbm_adr[15:2]];
+      if (wbm_we)
+        for (int b = 0; b < 4; b++)
+          if (wbm_sel[b]) mem[wbm_adr[15:2]][8*b +: 8] <= wbm_wdat[8*b +: 8];
+    end
+  end
+
+  // ---- Cycle, bus and block accounting ----
+  longint cycle, bus_cycles, blocks;
+
+  always @(posedge clk) begin
+    cycle++;
+    if (wb_cyc && wb_stb) bus_cycles++;
+    for (int i = 0; i < NUM_CORES; i++)
+      if (dut.done[i]) blocks++;
+  end
+
+  int errors, checks;
+
+  // ---- Watchdog: a DUT that never acks or never sets DONE fails the run instead of hanging it ----
+  localparam longint CYCLE_LIMIT = (WATCHDOG != 0) ? WATCHDOG : (LONG_VECTORS ? 40_000_000 : 2_000_000);
+
+  always @(posedge clk)
+    if (cycle > CYCLE_LIMIT)
+      $fatal(1, "❌ FAIL: watchdog, still running after %0d cycles (bus %s, %0d errors in %0d checks)",
+             CYCLE_LIMIT, (wb_cyc && wb_stb) ? $sformatf("waiting for ack at %04x", wb_adr) : "idle",
+             errors, checks);
+
+  task automatic check(string label, logic [255:0] got, logic [255:0] exp);
+    checks++;
+    if (got !== exp) begin
+      errors++;
+      $error("❌ %s: got %064x, expected %064x", label, got, exp);
+    end
+  endtask
+
+  // ---- Wishbone master (classic cycles and bursts, shared by the forked streams) ----
+  semaphore bus = new(1);
+
+  task automatic wb_write(logic [13:0] adr, logic [31:0] dat);
+    bus.get(1);
+    @(posedge clk);
+    wb_cyc <= 1'b1; wb_stb <= 1'b1; wb_we <= 1'b1; wb_adr <= adr; wb_wdat <= dat;
+    do @(posedge clk); while (!wb_ack);
+    wb_cyc <= 1'b0; wb_stb <= 1'b0; wb_we <= 1'b0;
+    bus.put(1);
+  endtask
+
+  task automatic wb_read(logic [13:0] adr, output logic [31:0] dat);
+    bus.get(1);
+    @(posedge clk);
+    wb_cyc <= 1'b1; wb_stb <= 1'b1; wb_we <= 1'b0; wb_adr <= adr;
+    do @(posedge clk); while (!wb_ack);
+    dat = wb_rdat;
+    wb_cyc <= 1'b0; wb_stb <= 1'b0;
+    bus.put(1);
+  endtask
+
+  // Registered-feedback incrementing burst: CTI = 010 on every beat but the
+  // last (111), one beat per ack, address +4 per beat
+  task automatic wb_burst_write(logic [13:0] adr, input logic [31:0] dat [$]);
+    bus.get(1);
+    @(posedge clk);
+    foreach (dat[k]) begin
+      wb_cyc <= 1'b1; wb_stb <= 1'b1; wb_we <= 1'b1;
+      wb_adr <= adr + 14'(4 * k); wb_wdat <= dat[k];
+      wb_cti <= (k == dat.size() - 1) ? CTI_END : CTI_INC_BURST;
+      do @(posedge clk); while (!wb_ack);
+    end
+    wb_cyc <= 1'b0; wb_stb <= 1'b0; wb_we <= 1'b0; wb_cti <= CTI_CLASSIC;
+    bus.put(1);
+  endtask
+
+  task automatic wb_burst_read(logic [13:0] adr, int n, output logic [31:0] dat [$]);
+    dat = {};
+    bus.get(1);
+    @(posedge clk);
+    for (int k = 0; k < n; k++) begin
+      wb_cyc <= 1'b1; wb_stb <= 1'b1; wb_we <= 1'b0;
+      wb_adr <= adr + 14'(4 * k);
+      wb_cti <= (k == n - 1) ? CTI_END : CTI_INC_BURST;
+      do @(posedge clk); while (!wb_ack);
+      dat.push_back(wb_rdat);
+    end
+    wb_cyc <= 1'b0; wb_stb <= 1'b0; wb_cti <= CTI_CLASSIC;
+    bus.put(1);
+  endtask
+
+  // ---- Driver: one message on one core, the way sha256.c streams it ----
+  // Full blocks are chained with CONTINUE, the tail goes out as a FINAL block.
+  // auto_len picks between AUTO_LEN and the BITLEN registers. mode may add
+  // CTRL_IPAD (first block, state from the key slot), CTRL_DOUBLE or
+  // CTRL_HMAC (FINAL) and the key slot in [17:16].
+  task automatic hash_core(int core, input msg_t m, bit auto_len, output logic [255:0] digest,
+                           input logic [31:0] mode = 32'h0);
+    logic [13:0] base = 14'(core * 14'h200);
+    logic [31:0] r, ctrl;
+    logic [31:0] slot = mode & (32'h3 << SLOT_LSB);
+    int nblk = m.size() / 64;
+    int n = m.size() % 64;
+    longint bits = (64'(m.size()) + ((mode & CTRL_IPAD) ? 64 : 0)) * 8;  // The key block counts
+
+    for (int b = 0; b <= nblk; b++) begin
+      if (b > 0)
+        do wb_read(base + REG_STATUS, r); while (r & STATUS_FULL);
+      for (int i = 0; i < ((b < nblk) ? 16 : (n + 3) / 4); i++)
+        wb_write(base + REG_MSG_BASE + 4 * i, msg_word(m, b, i));
+      if (b == 0 && !(mode & CTRL_IPAD))
+        for (int i = 0; i < 8; i++) wb_write(base + REG_STATE_IN + 4 * i, SHA256_IV[i]);
+
+      ctrl = CTRL_GO | ((b > 0) ? CTRL_CONTINUE : 0);
+      if (b == 0) ctrl |= (mode & CTRL_IPAD) | slot;
+      if (b == nblk) begin
+        ctrl |= CTRL_FINAL | (32'(n) << 8) | (mode & (CTRL_DOUBLE | CTRL_HMAC)) | slot;
+        if (auto_len)
+          ctrl |= CTRL_AUTO_LEN;
+        else begin
+          wb_write(base + REG_BITLEN_HI, 32'(bits >> 32));
+          wb_write(base + REG_BITLEN_LO, 32'(bits));
+        end
+      end
+      wb_write(base + REG_CONTROL, ctrl);
+    end
+
+    do wb_read(base + REG_CONTROL, r); while ((r & (CTRL_DONE | CTRL_BUSY)) != CTRL_DONE);
+    for (int i = 0; i < 8; i++) begin
+      wb_read(base + REG_STATE_OUT + 4 * i, r);
+      digest[255 - 32*i -: 32] = r;
+    end
+    wb_write(base + REG_CONTROL, 32'h0);  // Release the core (clears DONE)
+  endtask
+
+  // ---- Tests ----
+  task automatic test_nist();
+    string       msgs [4] = '{
+      "",
+      "abc",
+      "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+      "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu"
+    };
+    logic [255:0] exp [4] = '{
+      256'he3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855,
+      256'hba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad,
+      256'h248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1,
+      256'hcf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1
+    };
+    logic [255:0] got;
+
+    $display(">>> NIST vectors");
+    for (int v = 0; v < 4; v++) begin
+      check($sformatf("reference model, vector %0d", v), ref_sha256(str_msg(msgs[v])), exp[v]);
+      for (int c = 0; c < NUM_CORES; c++) begin
+        hash_core(c, str_msg(msgs[v]), v[0], got);
+        check($sformatf("core %0d, vector %0d", c, v), got, exp[v]);
+      end
+    end
+
+    if (LONG_VECTORS) begin
+      msg_t m;
+      for (int i = 0; i < 1000000; i++) m.push_back("a");
+      hash_core(0, m, 1'b1, got);
+      check("core 0, 1,000,000 x 'a'", got, 256'hcdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0);
+    end
+  endtask
+
+  task automatic test_latency();
+    msg_t m = str_msg("abc");
+    logic [31:0] r;
+    longint t0;
+
+    // Padded block written directly, so the measurement covers GO to DONE only
+    m = pad(m);
+    for (int i = 0; i < 16; i++) wb_write(REG_MSG_BASE + 4 * i, msg_word(m, 0, i));
+    for (int i = 0; i < 8; i++) wb_write(REG_STATE_IN + 4 * i, SHA256_IV[i]);
+    wb_write(REG_CONTROL, CTRL_GO);
+    t0 = cycle;
+    @(posedge clk iff dut.done[0]);
+    $display(">>> Single block latency: %0d cycles from the GO write to DONE", cycle - t0);
+    do wb_read(REG_CONTROL, r); while ((r & (CTRL_DONE | CTRL_BUSY)) != CTRL_DONE);
+    wb_write(REG_CONTROL, 32'h0);
+  endtask
+
+  task automatic test_random();
+    msg_t         msgs [NUM_CORES][RAND_MSGS];
+    logic [255:0] got  [NUM_CORES][RAND_MSGS];
+    longint t0, bus0, blk0, cyc, nblk;
+    logic [31:0] perf_blocks;
+
+    for (int c = 0; c < NUM_CORES; c++)
+      for (int j = 0; j < RAND_MSGS; j++)
+        msgs[c][j] = rand_msg($urandom_range(0, RAND_MAX_LEN));
+
+    if (PERF_COUNTERS) wb_write(REG_PERF_BASE, 32'h3);  // Snapshot + clear: start the interval
+    t0 = cycle; bus0 = bus_cycles; blk0 = blocks;
+
+    // All cores at once, each streaming its own list
+    for (int c = 0; c < NUM_CORES; c++) begin
+      fork
+        automatic int core = c;
+        for (int j = 0; j < RAND_MSGS; j++)
+          hash_core(core, msgs[core][j], j[0], got[core][j]);
+      join_none
+    end
+    wait fork;
+
+    cyc  = cycle - t0;
+    nblk = blocks - blk0;
+    for (int c = 0; c < NUM_CORES; c++)
+      for (int j = 0; j < RAND_MSGS; j++)
+        check($sformatf("core %0d, random message %0d (%0d bytes)", c, j, msgs[c][j].size()),
+              got[c][j], ref_sha256(msgs[c][j]));
+
+    $display(">>> Random messages: %0d blocks on %0d cores in %0d cycles", nblk, NUM_CORES, cyc);
+    $display("    %0d.%02d cycles per block, bus busy %0d%% of the cycles",
+             cyc / nblk, (cyc * 100 / nblk) % 100, (bus_cycles - bus0) * 100 / cyc);
+
+    if (PERF_COUNTERS) begin
+      wb_write(REG_PERF_BASE, 32'h1);
+      wb_read(REG_PERF_BASE + 14'h08, perf_blocks);
+      if (perf_blocks != nblk) begin
+        errors++;
+        $error("❌ Performance counter: %0d blocks, testbench counted %0d", perf_blocks, nblk);
+      end
+      checks++;
+    end
+  endtask
+
+  // Every context slot of core 0 streams its own message, one block per
+  // stream in turn; each block chains from its slot, not the core's last result
+  task automatic test_contexts();
+    localparam NBLK = 3;
+    msg_t         m [CTX_SLOTS];
+    logic [31:0]  r, ctrl;
+    logic [255:0] got;
+
+    for (int s = 0; s < CTX_SLOTS; s++)
+      m[s] = rand_msg(NBLK * 64 + $urandom_range(0, 63));
+
+    for (int b = 0; b <= NBLK; b++) begin
+      for (int s = 0; s < CTX_SLOTS; s++) begin
+        int n = m[s].size() % 64;
+        do wb_read(REG_STATUS, r); while (r & STATUS_FULL);
+        for (int i = 0; i < ((b < NBLK) ? 16 : (n + 3) / 4); i++)
+          wb_write(REG_MSG_BASE + 4 * i, msg_word(m[s], b, i));
+        if (b == 0)
+          for (int i = 0; i < 8; i++) wb_write(REG_STATE_IN + 4 * i, SHA256_IV[i]);
+        ctrl = CTRL_GO | ((b > 0) ? CTRL_CONTINUE : 0) | (32'(s) << CTX_LSB);
+        if (b == NBLK)
+          ctrl |= CTRL_FINAL | CTRL_AUTO_LEN | (32'(n) << 8);
+        wb_write(REG_CONTROL, ctrl);
+      end
+    end
+
+    do wb_read(REG_CONTROL, r); while ((r & (CTRL_DONE | CTRL_BUSY)) != CTRL_DONE);
+    $display(">>> Context slots: %0d interleaved streams on core 0", CTX_SLOTS);
+    for (int s = 0; s < CTX_SLOTS; s++) begin
+      wb_write(REG_CTX_SEL, 32'(s));
+      for (int i = 0; i < 8; i++) begin
+        wb_read(REG_STATE_OUT + 4 * i, r);
+        got[255 - 32*i -: 32] = r;
+      end
+      check($sformatf("context %0d (%0d bytes)", s, m[s].size()), got, ref_sha256(m[s]));
+    end
+    wb_write(REG_CTX_SEL, 32'h0);
+    wb_write(REG_CONTROL, 32'h0);
+  endtask
+
+  // A disabled core keeps its clock stopped: a queued block waits, and runs
+  // as soon as the core is enabled again. A block parked in the middle of
+  // COMPRESS resumes where it stopped (with SHARED_K = 1 the K ROM keeps
+  // running meanwhile)
+  task automatic test_enable();
+    localparam COMPRESS = 3'd3;
+    msg_t        m = pad(str_msg("abc"));
+    logic [31:0] r;
+    logic [255:0] got;
+    longint t0;
+
+    // At ROUNDS_PER_CYCLE = 8 COMPRESS is over before the bus write lands
+    for (int mid = 0; mid < ((ROUNDS_PER_CYCLE <= 4) ? 2 : 1); mid++) begin
+      $display(">>> Core enable: core 0 held off %s", mid ? "in the middle of a block" : "before GO");
+      for (int i = 0; i < 16; i++) wb_write(REG_MSG_BASE + 4 * i, msg_word(m, 0, i));
+      for (int i = 0; i < 8; i++) wb_write(REG_STATE_IN + 4 * i, SHA256_IV[i]);
+      if (!mid) begin
+        wb_write(REG_CORE_EN, ~32'h1);
+        wb_read(REG_CORE_EN, r);
+        check("REG_CORE_ENABLE read back", r, 32'((1 << NUM_CORES) - 2));
+        wb_write(REG_CONTROL, CTRL_GO);
+      end else begin
+        wb_write(REG_CONTROL, CTRL_GO);
+        @(posedge clk iff dut.core_state[0] == COMPRESS);
+        wb_write(REG_CORE_EN, ~32'h1);
+      end
+      repeat (200) @(posedge clk);
+      if (mid) check("core 0 parked in COMPRESS", 256'(dut.core_state[0]), 256'(COMPRESS));
+      wb_read(REG_CONTROL, r);
+      check("disabled core 0 still BUSY, not DONE", r & (CTRL_DONE | CTRL_BUSY), CTRL_BUSY);
+
+      wb_write(REG_CORE_EN, 32'hFFFF_FFFF);
+      t0 = cycle;
+      @(posedge clk iff dut.done[0]);
+      $display("    enabled again: DONE %0d cycles later", cycle - t0);
+      do wb_read(REG_CONTROL, r); while ((r & (CTRL_DONE | CTRL_BUSY)) != CTRL_DONE);
+      for (int i = 0; i < 8; i++) begin
+        wb_read(REG_STATE_OUT + 4 * i, r);
+        got[255 - 32*i -: 32] = r;
+      end
+      check("core 0 after re-enable", got, ref_sha256(str_msg("abc")));
+      wb_write(REG_CONTROL, 32'h0);
+    end
+  endtask
+
+  // AUTO_LEN against the explicit BITLEN registers at every padding edge,
+  // where the length moves into an extra block
+  task automatic test_auto_len();
+    int          lens [] = '{0, 1, 55, 56, 63, 64, 65, 119, 120, 127, 128, 183, 184};
+    logic [255:0] got;
+
+    $display(">>> AUTO_LEN at the padding edges (%0d lengths)", lens.size());
+    foreach (lens[l]) begin
+      msg_t m = rand_msg(lens[l]);
+      for (int a = 0; a < 2; a++) begin
+        hash_core(NUM_CORES - 1, m, a[0], got);
+        check($sformatf("%0d bytes, %s", lens[l], a ? "AUTO_LEN" : "BITLEN"), got, ref_sha256(m));
+      end
+    end
+  endtask
+
+  // Tagged jobs through the dispatcher: each block goes to whichever core is
+  // free, and the results are matched by tag from the completion FIFO. One
+  // CONTROL read per pass retires a result or submits, so a full FIFO holding
+  // the cores back never stalls the loop.
+  task automatic test_jobs();
+    localparam N = 3 * NUM_CORES + 1;
+    msg_t         m [N];
+    logic [31:0]  r, tag;
+    logic [255:0] got;
+    bit           seen [N];
+    int           j = 0, n = 0;
+    longint       t0;
+
+    for (int k = 0; k < N; k++) m[k] = rand_msg($urandom_range(0, 55));  // One padded block each
+
+    t0 = cycle;
+    while (n < N) begin
+      wb_read(REG_JOB_BASE + REG_CONTROL, r);
+      if (!(r & JOB_RESULT)) begin
+        if (j < N && !(r & JOB_PENDING)) begin
+          msg_t p = pad(m[j]);
+          for (int i = 0; i < 16; i++) wb_write(REG_JOB_BASE + REG_MSG_BASE + 4 * i, msg_word(p, 0, i));
+          for (int i = 0; i < 8; i++) wb_write(REG_JOB_BASE + REG_STATE_IN + 4 * i, SHA256_IV[i]);
+          wb_write(REG_JOB_BASE + REG_CONTROL, CTRL_GO | JOB_TAGGED | (32'(j) << 16));
+          j++;
+        end
+      end else begin
+        wb_read(REG_JOB_TAG, tag);
+        for (int i = 0; i < 8; i++) begin
+          wb_read(REG_JOB_BASE + REG_STATE_OUT + 4 * i, r);
+          got[255 - 32*i -: 32] = r;
+        end
+        wb_write(REG_JOB_POP, 32'h0);
+        if (tag >= N || seen[tag]) begin
+          errors++;
+          $error("❌ Tagged job: unexpected tag %0d", tag);
+        end else begin
+          seen[tag] = 1;
+          check($sformatf("tagged job %0d", tag), got, ref_sha256(m[tag]));
+        end
+        n++;
+      end
+    end
+    $display(">>> Job dispatcher: %0d tagged jobs on %0d cores in %0d cycles", N, NUM_CORES, cycle - t0);
+  endtask
+
+  // SHA256d on the outer block the register file queues itself, and HMAC
+  // from a key slot: ipad midstate as state_in, opad midstate for the outer hash
+  task automatic test_double();
+    msg_t         key = rand_msg(32), kx;
+    logic [31:0]  h [0:7], blk [0:15];
+    logic [255:0] got, inner;
+    localparam SLOT = 1;
+
+    $display(">>> SHA256d and HMAC (key slot %0d)", SLOT);
+    foreach (key[i]) kx.push_back(key[i]);
+    while (kx.size() < 64) kx.push_back(8'h00);
+    for (int pass = 0; pass < 2; pass++) begin             // 0: ipad, 1: opad
+      h = SHA256_IV;
+      for (int i = 0; i < 16; i++) blk[i] = msg_word(kx, 0, i) ^ (pass ? 32'h5c5c5c5c : 32'h36363636);
+      ref_compress(h, blk);
+      for (int i = 0; i < 8; i++) wb_write(REG_HMAC_BASE + 14'(SLOT * 'h40 + pass * 'h20 + 4 * i), h[i]);
+    end
+
+    for (int t = 0; t < 3; t++) begin
+      msg_t m = rand_msg(t * 60 + 3), ki, ko, d;
+
+      hash_core(0, m, t[0], got, CTRL_DOUBLE);
+      check($sformatf("SHA256d, %0d bytes", m.size()), got, ref_sha256(digest_msg(ref_sha256(m))));
+
+      foreach (kx[i]) ki.push_back(kx[i] ^ 8'h36);
+      foreach (kx[i]) ko.push_back(kx[i] ^ 8'h5c);
+      foreach (m[i]) ki.push_back(m[i]);                   // H(K ^ ipad || m)
+      inner = ref_sha256(ki);
+      d = digest_msg(inner);
+      foreach (d[i]) ko.push_back(d[i]);                   // H(K ^ opad || inner)
+      hash_core(0, m, 1'b1, got, CTRL_IPAD | CTRL_HMAC | (32'(SLOT) << SLOT_LSB));
+      check($sformatf("HMAC, %0d bytes", m.size()), got, ref_sha256(ko));
+    end
+  endtask
+
+  // The same block written, hashed and read back with classic cycles and with
+  // incrementing bursts (24 words of msg + state_in, 8 words of state_out)
+  task automatic test_burst();
+    msg_t         m = pad(rand_msg(40));
+    logic [31:0]  wr [$], rd [$], r;
+    logic [255:0] got;
+    longint       t0, cyc [2];
+
+    for (int i = 0; i < 16; i++) wr.push_back(msg_word(m, 0, i));
+    for (int i = 0; i < 8; i++) wr.push_back(SHA256_IV[i]);
+
+    for (int burst = 0; burst < 2; burst++) begin
+      t0 = cycle;
+      if (burst) wb_burst_write(REG_MSG_BASE, wr);
+      else foreach (wr[k]) wb_write(REG_MSG_BASE + 14'(4 * k), wr[k]);
+      cyc[burst] = cycle - t0;
+      wb_write(REG_CONTROL, CTRL_GO);
+      do wb_read(REG_CONTROL, r); while ((r & (CTRL_DONE | CTRL_BUSY)) != CTRL_DONE);
+      t0 = cycle;
+      if (burst) wb_burst_read(REG_STATE_OUT, 8, rd);
+      else begin
+        rd = {};
+        for (int i = 0; i < 8; i++) begin
+          wb_read(REG_STATE_OUT + 4 * i, r);
+          rd.push_back(r);
+        end
+      end
+      cyc[burst] += cycle - t0;
+      foreach (rd[i]) got[255 - 32*i -: 32] = rd[i];
+      check(burst ? "burst transfer" : "classic transfer", got, ref_sha256(m[0:39]));
+      wb_write(REG_CONTROL, 32'h0);
+    end
+    $display(">>> Bursts: 32-word block transfer in %0d cycles, %0d with classic cycles (%0d saved)",
+             cyc[1], cyc[0], cyc[0] - cyc[1]);
+  endtask
+
+  task automatic test_dma();
+    msg_t m = rand_msg($urandom_range(1, 1000));
+    logic [255:0] got;
+    logic [31:0] r;
+    longint t0;
+
+    for (int i = 0; i < m.size(); i++)
+      mem[(DMA_SRC + i) >> 2][8 * (i % 4) +: 8] = m[i];
+
+    t0 = cycle;
+    wb_write(REG_DMA_BASE + 14'h00, 32'((NUM_CORES - 1) << 8));
+    wb_write(REG_DMA_BASE + 14'h04, DMA_SRC);
+    wb_write(REG_DMA_BASE + 14'h08, m.size());
+    wb_write(REG_DMA_BASE + 14'h0C, DMA_DST);
+    do wb_read(REG_DMA_BASE, r); while (r[0]);
+    $display(">>> DMA: %0d bytes in %0d cycles", m.size(), cycle - t0);
+
+    if (r[30]) begin
+      errors++;
+      $error("❌ DMA: bus error");
+    end
+    for (int i = 0; i < 32; i++)
+      got[255 - 8*i -: 8] = mem[(DMA_DST + i) >> 2][8 * (i % 4) +: 8];
+    check("DMA digest", got, ref_sha256(m));
+    wb_write(14'((NUM_CORES - 1) * 14'h200) + REG_CONTROL, 32'h0);
+  endtask
+
+  task automatic test_pipe();
+    localparam N = 32;
+    msg_t m [N];
+    logic [31:0] r;
+    logic [255:0] got;
+    longint t0;
+    int sent = 0, recv = 0;
+
+    for (int j = 0; j < N; j++) m[j] = rand_msg($urandom_range(0, 55));
+
+    t0 = cycle;
+    while (recv < N) begin
+      wb_read(REG_PIPE_BASE + REG_CONTROL, r);
+      if (r[31]) begin                         // Collect the head result
+        int tag = r[15:8];
+        for (int i = 0; i < 8; i++) begin
+          wb_read(REG_PIPE_BASE + REG_STATE_OUT + 4 * i, r);
+          got[255 - 32*i -: 32] = r;
+        end
+        wb_write(REG_PIPE_POP, 32'h0);
+        check($sformatf("pipe, tag %0d", tag), got, ref_sha256(m[tag]));
+        recv++;
+      end else if (sent < N && !r[0]) begin    // Submit the next block
+        msg_t p = pad(m[sent]);
+        for (int i = 0; i < 16; i++) wb_write(REG_PIPE_BASE + REG_MSG_BASE + 4 * i, msg_word(p, 0, i));
+        for (int i = 0; i < 8; i++) wb_write(REG_PIPE_BASE + REG_STATE_IN + 4 * i, SHA256_IV[i]);
+        wb_write(REG_PIPE_BASE + REG_CONTROL, CTRL_GO | (32'(sent) << 8));
+        sent++;
+      end
+    end
+    $display(">>> Pipelined core: %0d blocks in %0d cycles", N, cycle - t0);
+  endtask
+
+  initial begin
+    logic [31:0] id;
+
+    clk = 0;
+    core_clk = 0;
+    rst = 1;
+    cycle = 0; bus_cycles = 0; blocks = 0;
+    errors = 0; checks = 0;
+    wb_cyc = 0; wb_stb = 0; wb_we = 0; wb_adr = 0; wb_wdat = 0;
+    wb_cti = 3'b000; wb_bte = 2'b00; wb_sel = 4'hf;
+    wbm_ack = 0;
+    foreach (mem[i]) mem[i] = 32'h0;
+    void'($urandom(SEED));
+    #20 rst = 0;
+
+    wb_read(REG_ID, id);
+    $display(">>> REG_ID = %08x (%0d cores, ROUNDS_PER_CYCLE = %0d, ONLINE_SCHEDULE = %0d, SHARED_K = %0d, FAST_WB = %0d, CORE_CLK = %0d)",
+             id, id[7:0], ROUNDS_PER_CYCLE, ONLINE_SCHEDULE, SHARED_K, FAST_WB, CORE_CLK);
+
+    test_nist();
+    test_latency();
+    test_random();
+    if (CTX_SLOTS > 1) test_contexts();
+    test_enable();
+    test_auto_len();
+    test_jobs();
+    test_double();
+    if (FAST_WB) test_burst();
+    if (DMA_ENGINE) test_dma();
+    if (PIPE_CORE)  test_pipe();
+
+    if (errors == 0)
+      $display("✅ PASS: %0d checks", checks);
+    else
+      $fatal(1, "❌ FAIL: %0d of %0d checks", errors, checks);
+    $finish;
+  end
+
+endmodule
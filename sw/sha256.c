@@ -1,3 +1,4 @@
+#include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -15,21 +16,251 @@
 #define DBL_INT_ADD(a,b,c) if (a > 0xffffffff - (c)) ++b; a += c;
 
 // ------------------------
-// Register address map for accelerator 0 (base = 0x80001300)
+// Build configuration (override with -D). Everything is resolved here, so the
+// transform and update paths carry no runtime capability checks
+//   SHA256_BACKEND    SHA256_BACKEND_HW: accelerator cores (default with NUM_CORES > 0)
+//                     SHA256_BACKEND_SW: CPU only, for boards without the accelerator
+//                     SHA256_BACKEND_HYBRID: cores, SHA256Batch() lets the CPU steal (SHA256Hybrid)
+//   NUM_CORES         accelerator_top NUM_CORES; 0 selects the software backend
+//   SHA256_CHAINED    0: cores without CONTINUE/FINAL, state goes with every block, software padding
+//   SHA256_JOB_FIFO   0: no tagged completion FIFO, SHA256Jobs() runs SHA256Batch()
+//   SHA256_DMA        1: DMA_ENGINE = 1, SHA256Bytes() hands large aligned buffers to the DMA engine
+//   SHA256_CTX_SLOTS  accelerator_top CTX_SLOTS; 1 keeps one open stream per core
+// ------------------------
+#define SHA256_BACKEND_SW        0
+#define SHA256_BACKEND_HW        1
+#define SHA256_BACKEND_HYBRID    2
+
+#ifndef NUM_CORES
+#define NUM_CORES                2   // Must match accelerator_top NUM_CORES
+#endif
+#ifndef SHA256_BACKEND
+#if NUM_CORES > 0
+#define SHA256_BACKEND           SHA256_BACKEND_HW
+#else
+#define SHA256_BACKEND           SHA256_BACKEND_SW
+#endif
+#endif
+#ifndef SHA256_CHAINED
+#define SHA256_CHAINED           1
+#endif
+#ifndef SHA256_JOB_FIFO
+#define SHA256_JOB_FIFO          1
+#endif
+#ifndef SHA256_DMA
+#define SHA256_DMA               0
+#endif
+#ifndef SHA256_CTX_SLOTS
+#define SHA256_CTX_SLOTS         4   // Must match accelerator_top CTX_SLOTS
+#endif
+#ifndef SHA256_DMA_MIN_LEN
+#define SHA256_DMA_MIN_LEN     256   // Shortest message SHA256Bytes() sends through the DMA engine
+#endif
+#ifndef SHA256_SW_MAX_LEN
+#define SHA256_SW_MAX_LEN       55   // Longest message the CPU steals in SHA256Hybrid()
+#endif
+
+#define SHA256_HW                (SHA256_BACKEND != SHA256_BACKEND_SW)
+
+#if SHA256_HW && (NUM_CORES < 1 || NUM_CORES > 16)
+#error "NUM_CORES must be between 1 and 16 for a hardware backend"
+#endif
+#if SHA256_HW && (SHA256_CTX_SLOTS < 1 || SHA256_CTX_SLOTS > 16)
+#error "SHA256_CTX_SLOTS must be between 1 and 16"
+#endif
+#if SHA256_DMA && !SHA256_HW
+#error "SHA256_DMA needs a hardware backend"
+#endif
+#if !SHA256_HW
+#undef SHA256_USE_IRQ                // Nothing to wait for
+#endif
+
+// ------------------------
+// Register address map (core i base = 0x80001300 + i * 0x200)
 // ------------------------
 #define REG_BASE0                0x80001300
+#define REG_BASE1                0x80001500
+#define REG_BASE(core)           (REG_BASE0 + (core) * 0x200)
+#if NUM_CORES == 1
+#define SHA256_CTX_BASE(ctx)     REG_BASE0   // Constant: register addresses fold into immediates
+#else
+#define SHA256_CTX_BASE(ctx)     ((ctx)->base)
+#endif
 #define REG_CONTROL(base)        (base + 0x00)
 #define REG_MSG_BASE(base)       (base + 0x04)
 #define REG_STATE_IN_BASE(base)  (base + 0x44)
 #define REG_STATE_OUT_BASE(base) (base + 0x64)
 
+// Global window: core info and the shared job dispatcher
+#define REG_GLOBAL_BASE          (REG_BASE0 + 0x2000)
+#define REG_ID                   (REG_GLOBAL_BASE + 0x00)
+#define REG_IDLE_MASK            (REG_GLOBAL_BASE + 0x04)
+#define REG_DONE_MASK            (REG_GLOBAL_BASE + 0x08)
+#define REG_IRQ_STATUS           (REG_GLOBAL_BASE + 0x0C)   // Write 1 to clear
+#define REG_IRQ_MASK             (REG_GLOBAL_BASE + 0x10)
+#define IRQ_DMA                  0x00010000u                // IRQ bits above the cores: engine job ended
+#define IRQ_NONCE                0x00020000u
+#define IRQ_MERKLE               0x00040000u
+#define REG_CORE_ENABLE          (REG_GLOBAL_BASE + 0x14)   // Bit per core, all set at reset
+#define REG_JOB_BASE             (REG_GLOBAL_BASE + 0x200)  // Same layout as a core window
+#define REG_PIPE_BASE            (REG_GLOBAL_BASE + 0x400)  // Pipelined core (PIPE_CORE = 1)
+#define REG_STATUS(base)         (base + 0x84)
+#define REG_BITLEN_HI(base)      (base + 0x88)
+#define REG_BITLEN_LO(base)      (base + 0x8C)
+#define REG_CTX_SEL(base)        (base + 0x90)   // Context slot shown at state_out
+#define REG_LE_VIEW(base)        (base + 0x100)  // Message and state_out byte-swapped
+#define REG_PIPE_POP             (REG_PIPE_BASE + 0x88)
+#define REG_JOB_TAG              (REG_JOB_BASE + 0x90)      // Tag of the oldest completion
+#define REG_JOB_POP              (REG_JOB_BASE + 0x94)
+#define REG_DMA_BASE             (REG_GLOBAL_BASE + 0x600)  // DMA engine (DMA_ENGINE = 1)
+#define REG_DMA_CONTROL          (REG_DMA_BASE + 0x00)
+#define REG_DMA_SRC              (REG_DMA_BASE + 0x04)
+#define REG_DMA_LEN              (REG_DMA_BASE + 0x08)
+#define REG_DMA_DST              (REG_DMA_BASE + 0x0C)
+#define REG_NONCE_BASE           (REG_GLOBAL_BASE + 0x800)  // Nonce sweep engine (NONCE_LANES > 0)
+#define REG_NONCE_CONTROL        (REG_NONCE_BASE + 0x00)
+#define REG_NONCE_TEMPLATE       (REG_NONCE_BASE + 0x04)
+#define REG_NONCE_MIDSTATE       (REG_NONCE_BASE + 0x44)
+#define REG_NONCE_TARGET         (REG_NONCE_BASE + 0x64)
+#define REG_NONCE_START          (REG_NONCE_BASE + 0x84)
+#define REG_NONCE_COUNT          (REG_NONCE_BASE + 0x88)
+#define REG_NONCE_NEXT           (REG_NONCE_BASE + 0x8C)
+#define REG_NONCE_FOUND          (REG_NONCE_BASE + 0x90)
+#define REG_NONCE_FOUND_POP      (REG_NONCE_BASE + 0x94)
+#define REG_HMAC_BASE            (REG_GLOBAL_BASE + 0xA00)  // HMAC key slots
+#define REG_HMAC_IPAD(slot)      (REG_HMAC_BASE + (slot) * 0x40)
+#define REG_HMAC_OPAD(slot)      (REG_HMAC_BASE + (slot) * 0x40 + 0x20)
+#define HMAC_SLOTS               4
+#define REG_MERKLE_BASE          (REG_GLOBAL_BASE + 0xC00)  // Merkle tree engine (MERKLE_LANES > 0)
+#define REG_MERKLE_CONTROL       (REG_MERKLE_BASE + 0x00)
+#define REG_MERKLE_COUNT         (REG_MERKLE_BASE + 0x04)
+#define REG_MERKLE_INDEX         (REG_MERKLE_BASE + 0x08)
+#define REG_MERKLE_SRC           (REG_MERKLE_BASE + 0x0C)
+#define REG_MERKLE_LEAF_PTR      (REG_MERKLE_BASE + 0x10)
+#define REG_MERKLE_LEAF_DATA     (REG_MERKLE_BASE + 0x14)
+#define REG_MERKLE_PATH_LEVEL    (REG_MERKLE_BASE + 0x18)
+#define REG_MERKLE_PATH_VALID    (REG_MERKLE_BASE + 0x1C)
+#define REG_MERKLE_ROOT          (REG_MERKLE_BASE + 0x24)
+#define REG_MERKLE_PATH          (REG_MERKLE_BASE + 0x44)
+#define REG_PERF_BASE            (REG_GLOBAL_BASE + 0xE00)  // Performance counters (PERF_COUNTERS = 1)
+#define REG_PERF_CONTROL         (REG_PERF_BASE + 0x00)
+#define REG_PERF_GLOBAL          (REG_PERF_BASE + 0x04)     // Aggregate counters
+#define REG_PERF_CORE            (REG_PERF_BASE + 0x40)     // Counters of the selected core
+
 // Read/write macros to memory-mapped registers
 #define READ_REG(addr) (*(volatile unsigned *) (addr))
 #define WRITE_REG(addr, val) (*(volatile unsigned *) (addr) = (val))
 
 // Control register bits
-#define CTRL_GO    0x00000001u
-#define CTRL_DONE  0x80000000u
+#define CTRL_GO        0x00000001u
+#define CTRL_CONTINUE  0x00000002u  // Chain onto the core's previous state_out
+#define CTRL_FINAL     0x00000004u  // Pad in hardware from REG_BITLEN and CTRL_NBYTES
+#define CTRL_NBYTES(n) (((n) & 0x3f) << 8)  // Valid message bytes in a FINAL block
+#define CTRL_DOUBLE    0x00000008u  // With FINAL: hash the digest again (SHA256d)
+#define CTRL_HMAC      0x00000010u  // With FINAL: outer hash under the slot's opad state
+#define CTRL_IPAD      0x00000020u  // Start from the slot's ipad state instead of state_in
+#define CTRL_SLOT(s)   (((s) & 0x3) << 16)  // HMAC key slot
+#define CTRL_AUTO_LEN  0x00000040u  // With FINAL: the core counts the bit length itself
+#define CTRL_CTX(c)    (((c) & 0xf) << 24)  // Context slot the block chains from and finishes into
+#define CTRL_BUSY      0x00000001u  // Read: a block is queued or hashing
+#define CTRL_DONE      0x80000000u
+
+// Core status register bits
+#define STATUS_OVERFLOW  0x00000001u
+#define STATUS_FULL      0x00000002u  // Fill bank still queued
+
+// The next block of a stream cannot be written into the core yet
+#if SHA256_CHAINED
+#define SHA256_CORE_FULL(base)   (READ_REG(REG_STATUS(base)) & STATUS_FULL)
+#else
+#define SHA256_CORE_FULL(base)   ((READ_REG(REG_CONTROL(base)) & (CTRL_DONE | CTRL_BUSY)) != CTRL_DONE)
+#endif
+
+// Context slot of a stream: sent with every GO, selected before its state is read back
+#if SHA256_HW && SHA256_CTX_SLOTS > 1
+#define SHA256_CTX_GO(ctx)            CTRL_CTX((ctx)->cid)
+#define SHA256_CTX_SELECT(base, ctx)  WRITE_REG(REG_CTX_SEL(base), (ctx)->cid)
+#else
+#define SHA256_CTX_GO(ctx)            0u
+#define SHA256_CTX_SELECT(base, ctx)  ((void) 0)
+#endif
+
+// Job window control register fields
+#define JOB_PENDING    0x00000001u
+#define JOB_CORE(val)  (((val) >> 8) & 0xf)
+#define JOB_RESULT     0x80000000u  // R: a tagged completion is waiting
+#define JOB_TAGGED     0x00000080u  // W: retire into the completion FIFO
+#define JOB_TAG(tag)   (((tag) & 0xff) << 16)
+#define JOB_SLOTS      16           // Tagged jobs in flight (<= JOB_FIFO_DEPTH)
+
+// Pipe window control register fields
+#define PIPE_FULL         0x00000001u
+#define PIPE_RESULT       0x80000000u
+#define PIPE_TAG(val)     (((val) >> 8) & 0xff)
+#define PIPE_GO(tag)      (CTRL_GO | (((tag) & 0xff) << 8))
+
+// REG_ID fields
+#define ID_NUM_CORES(val) ((val) & 0xff)
+#define ID_FEAT_PIPE      0x00000100u
+#define ID_FEAT_DMA       0x00000200u
+#define ID_FEAT_NONCE     0x00000400u
+#define ID_FEAT_HMAC      0x00000800u
+#define ID_FEAT_MERKLE    0x00001000u
+#define ID_FEAT_PERF      0x00002000u
+
+// REG_DMA_CONTROL bits
+#define DMA_BUSY          0x00000001u
+#define DMA_CORE(core)    (((core) & 0xf) << 8)
+#define DMA_CORE_ERROR    0x20000000u  // Start named a core that is not built (job refused)
+#define DMA_BUS_ERROR     0x40000000u
+#define DMA_DONE          0x80000000u
+
+// REG_NONCE_CONTROL bits
+#define NONCE_GO          0x00000001u  // W: start the sweep
+#define NONCE_STOP        0x00000002u  // W: stop after the current pass
+#define NONCE_DOUBLE      0x00000004u  // SHA256d
+#define NONCE_LE          0x00000008u  // Nonce stored little-endian in its word
+#define NONCE_CMP_LE      0x00000010u  // Digest compared as a little-endian number
+#define NONCE_WORD(i)     (((i) & 0xf) << 8)
+#define NONCE_BUSY        0x00000001u  // R: sweep running
+#define NONCE_FOUND_COUNT(val) (((val) >> 16) & 0xff)
+#define NONCE_FOUND_OVF   0x40000000u  // R: a match was dropped (FIFO full)
+
+// REG_MERKLE_CONTROL bits
+#define MERKLE_GO         0x00000001u  // W: reduce the node buffer
+#define MERKLE_LOAD       0x00000002u  // W: fetch the leaves from REG_MERKLE_SRC first
+#define MERKLE_DUP_ODD    0x00000004u  // Odd last node is hashed with itself (Bitcoin)
+#define MERKLE_BUSY       0x00000001u  // R: reduction running
+#define MERKLE_DEPTH(val) (((val) >> 16) & 0x1f)
+#define MERKLE_BUS_ERROR  0x40000000u
+#define MERKLE_DONE       0x80000000u
+
+// REG_PERF_CONTROL bits
+#define PERF_SNAPSHOT     0x00000001u  // W: copy the counters for readback
+#define PERF_CLEAR        0x00000002u  // W: restart the counters (after the copy)
+#define PERF_CORE(core)   (((core) & 0xf) << 8)  // Core shown at REG_PERF_CORE
+
+// ------------------------
+// SHA256 initial hash state (A-H)
+// ------------------------
+static const uint SHA256_IV[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+// ------------------------
+// SHA256 round constants (software path)
+// ------------------------
+static const uint SHA256_K[64] = {
+    0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
+    0xd807aa98,0x12835b01,0x243185be,0x550c7dc3,0x72be5d74,0x80deb1fe,0x9bdc06a7,0xc19bf174,
+    0xe49b69c1,0xefbe4786,0x0fc19dc6,0x240ca1cc,0x2de92c6f,0x4a7484aa,0x5cb0a9dc,0x76f988da,
+    0x983e5152,0xa831c66d,0xb00327c8,0xbf597fc7,0xc6e00bf3,0xd5a79147,0x06ca6351,0x14292967,
+    0x27b70a85,0x2e1b2138,0x4d2c6dfc,0x53380d13,0x650a7354,0x766a0abb,0x81c2c92e,0x92722c85,
+    0xa2bfe8a1,0xa81a664b,0xc24b8b70,0xc76c51a3,0xd192e819,0xd6990624,0xf40e3585,0x106aa070,
+    0x19a4c116,0x1e376c08,0x2748774c,0x34b0bcb5,0x391c0cb3,0x4ed8aa4a,0x5b9cca4f,0x682e6ff3,
+    0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2
+};
 
 // ------------------------
 // SHA256 context struct (RAM-side state)
@@ -39,139 +270,1156 @@ typedef struct {
     uint datalen;       // Number of bytes currently in data[]
     uint bitlen[2];     // Total message length in bits (hi/lo)
     uint state[8];      // SHA256 state (A-H)
+    uint base;          // Register base of the accelerator core serving this context
+    uint cid;           // Context slot of that core holding the chained state
+    uint pending;       // Non-zero while state[] lives in the core (blocks chained in flight)
+    uint open;          // Last block went out with CONTINUE: the core raises no interrupt for it
+    uint mode;          // CTRL_DOUBLE / CTRL_HMAC | CTRL_IPAD | CTRL_SLOT bits sent with the GOs
+    uint restarted;     // State was read back mid-stream, the core's block count is partial
 } SHA256_CTX;
 
 // ------------------------
-// Send one 512-bit block to the accelerator
+// One message of a batch (SHA256Batch)
 // ------------------------
-void SHA256Transform(SHA256_CTX *ctx, uchar data[]) {
+typedef struct {
+    uchar *data;        // Message bytes
+    uint len;           // Message length in bytes
+} SHA256_MSG;
+
+#if SHA256_HW
+// ------------------------
+// Performance counter snapshot (SHA256PerfSample)
+// ------------------------
+typedef struct {
+    uint cycles;        // Clock cycles
+    uint blocks;        // Blocks finished, all cores
+    uint reads;         // Register reads (bus and DMA engine)
+    uint writes;        // Register writes
+    uint busy;          // Cycles with at least one core hashing
+    struct {
+        uint blocks;
+        uint idle;      // Nothing queued, no result waiting
+        uint load;
+        uint expand;
+        uint compress;
+        uint done;
+        uint stall;     // Result waiting for the next GO or a collect
+        uint reads;     // Register reads of the core's window
+        uint writes;
+    } core[NUM_CORES];
+} SHA256_PERF;
+#endif
+
+// ------------------------
+// Big-endian state words to digest bytes
+// ------------------------
+static void SHA256StateBytes(uint state[], uchar hash[]) {
+    for (int i = 0; i < 8; i++) {
+        hash[i * 4]     = state[i] >> 24;
+        hash[i * 4 + 1] = state[i] >> 16;
+        hash[i * 4 + 2] = state[i] >> 8;
+        hash[i * 4 + 3] = state[i];
+    }
+}
+
+// ------------------------
+// Software SHA256 on the CPU (the transform the accelerator replaces). It is
+// the software backend, pads for cores without FINAL, and SHA256Hybrid()
+// runs it as one more worker next to the cores
+// ------------------------
+#define ROTRIGHT(a,b) (((a) >> (b)) | ((a) << (32-(b))))
+#define EP0(x)  (ROTRIGHT(x,2) ^ ROTRIGHT(x,13) ^ ROTRIGHT(x,22))
+#define EP1(x)  (ROTRIGHT(x,6) ^ ROTRIGHT(x,11) ^ ROTRIGHT(x,25))
+#define SIG0(x) (ROTRIGHT(x,7) ^ ROTRIGHT(x,18) ^ ((x) >> 3))
+#define SIG1(x) (ROTRIGHT(x,17) ^ ROTRIGHT(x,19) ^ ((x) >> 10))
+
+void SHA256SoftTransform(uint state[], uchar data[]) {
+    uint a, b, c, d, e, f, g, h, t1, t2, m[64];
+
+    for (int i = 0, j = 0; i < 16; ++i, j += 4)
+        m[i] = (data[j] << 24) | (data[j+1] << 16) | (data[j+2] << 8) | (data[j+3]);
+    for (int i = 16; i < 64; ++i)
+        m[i] = SIG1(m[i-2]) + m[i-7] + SIG0(m[i-15]) + m[i-16];
+
+    a = state[0]; b = state[1]; c = state[2]; d = state[3];
+    e = state[4]; f = state[5]; g = state[6]; h = state[7];
+
+    for (int i = 0; i < 64; ++i) {
+        t1 = h + EP1(e) + ((e & f) ^ (~e & g)) + SHA256_K[i] + m[i];
+        t2 = EP0(a) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+// ------------------------
+// Build the padded tail of a message (its last n < 64 bytes, 0x80, zeros,
+// the 64-bit bit length bitlen[1]:bitlen[0]) in tail[]; returns the number
+// of blocks (1 or 2)
+// ------------------------
+static uint SHA256PadTail(uchar *data, uint n, uint bitlen[], uchar tail[128]) {
+    uint nblk = (n > 55) ? 2 : 1;
+
+    memset(tail, 0, 128);
+    memcpy(tail, data, n);
+    tail[n] = 0x80;
+    for (int i = 0; i < 4; i++) {
+        tail[nblk * 64 - 1 - i] = (uchar) (bitlen[0] >> (8 * i));
+        tail[nblk * 64 - 5 - i] = (uchar) (bitlen[1] >> (8 * i));
+    }
+    return nblk;
+}
+
+// ------------------------
+// Padded tail of a whole len-byte message
+// ------------------------
+static uint SHA256SoftPad(uchar *data, uint len, uchar tail[128]) {
+    uint bitlen[2] = { len << 3, len >> 29 };
+
+    return SHA256PadTail(data + len - len % 64, len % 64, bitlen, tail);
+}
+
+// ------------------------
+// Finish a message whose full blocks are already in state
+// ------------------------
+static void SHA256SoftFinal(uint state[], uchar *data, uint len, uchar hash[]) {
+    uchar tail[128];
+    uint nblk = SHA256SoftPad(data, len, tail);
+
+    for (uint b = 0; b < nblk; b++)
+        SHA256SoftTransform(state, tail + b * 64);
+    SHA256StateBytes(state, hash);
+}
+
+// ------------------------
+// Hash len bytes on the CPU only
+// ------------------------
+void SHA256SoftBytes(uchar *data, uint len, uchar hash[]) {
+    uint state[8];
+
+    memcpy(state, SHA256_IV, sizeof(state));
+    for (uint i = 0; len - i >= 64; i += 64)
+        SHA256SoftTransform(state, data + i);
+    SHA256SoftFinal(state, data, len, hash);
+}
+
+#if SHA256_HW
+#ifdef SHA256_USE_IRQ
+// ------------------------
+// Interrupt-driven completion (build with -DSHA256_USE_IRQ)
+// SHA256_IRQ_NUM is the SweRV PIC source the SoC wires accelerator_top.int_o to
+// ------------------------
+#ifndef SHA256_IRQ_NUM
+#define SHA256_IRQ_NUM  4
+#endif
+
+static volatile uint sha256_irq_done;  // REG_IRQ_STATUS bits collected by the ISR
+
+static void SHA256Isr(void) {
+    uint status = READ_REG(REG_IRQ_STATUS);
+
+    WRITE_REG(REG_IRQ_STATUS, status);  // Acknowledge (drops int_o)
+    sha256_irq_done |= status;
+}
+
+void SHA256IrqInit(void) {
+    pspMachineInterruptsSetVecTableAddress(&M_PSP_VECT_TABLE);
+    pspMachineExtInterruptsSetPriorityOrder(D_PSP_EXT_INT_STANDARD_PRIORITY);
+    pspMachineExtInterruptSetThreshold(0);
+
+    pspMachineExtInterruptRegisterISR(SHA256_IRQ_NUM, SHA256Isr, 0);
+    pspMachineExtInterruptSetType(SHA256_IRQ_NUM, D_PSP_EXT_INT_LEVEL_TRIG_TYPE);
+    pspMachineExtInterruptSetPolarity(SHA256_IRQ_NUM, D_PSP_EXT_INT_ACTIVE_HIGH);
+    pspMachineExtInterruptSetPriority(SHA256_IRQ_NUM, 1);
+    pspMachineExtInterruptEnableNumber(SHA256_IRQ_NUM);
+
+    // The nonce sweep drains its matches while it runs, so it keeps polling
+    uint id = READ_REG(REG_ID);
+    uint mask = (1u << NUM_CORES) - 1;
+    if (id & ID_FEAT_DMA)    mask |= IRQ_DMA;
+    if (id & ID_FEAT_MERKLE) mask |= IRQ_MERKLE;
+
+    WRITE_REG(REG_IRQ_STATUS, 0xffffffffu);          // Drop stale completions
+    WRITE_REG(REG_IRQ_MASK, mask);
+    pspMachineInterruptsEnableIntNumber(D_PSP_INTERRUPTS_MACHINE_EXT);
+    pspMachineInterruptsEnable();
+}
+
+// ------------------------
+// Sleep until the ISR reports one of the REG_IRQ_STATUS bits in bit. MIE is
+// cleared around the test so a completion that lands before wfi still wakes the hart
+// ------------------------
+static void SHA256WaitIrq(uint bit) {
+    for (;;) {
+        __asm__ volatile ("csrc mstatus, 8");
+        if (sha256_irq_done & bit) break;
+        __asm__ volatile ("wfi");
+        __asm__ volatile ("csrs mstatus, 8");
+    }
+    sha256_irq_done &= ~bit;
+    __asm__ volatile ("csrs mstatus, 8");
+}
+
+// ------------------------
+// Drop completions nobody waits for, so a later wait does not skip its sleep
+// ------------------------
+static void SHA256IrqForget(uint bit) {
+    __asm__ volatile ("csrc mstatus, 8");
+    sha256_irq_done &= ~bit;
+    __asm__ volatile ("csrs mstatus, 8");
+}
+#endif
+
+// ------------------------
+// Wait until a core drained its queue and the last block set DONE. The core
+// only interrupts when a block that closes a stream drains (FINAL, or a GO
+// without CONTINUE), so a wait on an open CONTINUE block polls (sleep = 0)
+// ------------------------
+static void SHA256WaitCore(uint base, uint sleep) {
+#ifdef SHA256_USE_IRQ
+    if (sleep) SHA256WaitIrq(1u << ((base - REG_BASE0) >> 9));
+#else
+    (void) sleep;
+#endif
+    // Confirm: with context slots the bit may belong to another stream on the core
+    while ((READ_REG(REG_CONTROL(base)) & (CTRL_DONE | CTRL_BUSY)) != CTRL_DONE) {}
+}
+
+// ------------------------
+// Collect the result of the last block in flight (if any)
+// ------------------------
+void SHA256TransformWait(SHA256_CTX *ctx) {
+    uint base = SHA256_CTX_BASE(ctx);
+
+    if (!ctx->pending) return;
+
+    SHA256WaitCore(base, !ctx->open);
+    SHA256_CTX_SELECT(base, ctx);
+
+    // Read the updated SHA256 state from accelerator
+    for (int i = 0; i < 8; i++) {
+        ctx->state[i] = READ_REG(REG_STATE_OUT_BASE(base) + i * 4);
+    }
+    ctx->pending = 0;
+    ctx->restarted = 1;
+}
+
+// ------------------------
+// Write one 512-bit block into a register window
+// ------------------------
+static void SHA256WriteMsg(uint base, uchar data[]) {
     uint m[16];
-    uint base = REG_BASE0;
+
+    if (((unsigned long) data & 3) == 0) {
+        // Word-aligned buffer: native word loads, the little-endian view swaps them
+        uint *w = (uint *) data;
+        for (int i = 0; i < 16; ++i) {
+            WRITE_REG(REG_MSG_BASE(REG_LE_VIEW(base)) + i * 4, w[i]);
+        }
+        return;
+    }
 
     // Parse 64 bytes of message into 16 32-bit words
     for (int i = 0, j = 0; i < 16; ++i, j += 4) {
         m[i] = (data[j] << 24) | (data[j+1] << 16) | (data[j+2] << 8) | (data[j+3]);
         WRITE_REG(REG_MSG_BASE(base) + i * 4, m[i]);  // Write to accelerator input
     }
+}
 
-    // Write current SHA256 state
+// ------------------------
+// Write the input state of a block into a register window
+// ------------------------
+static void SHA256WriteState(uint base, uint state[]) {
     for (int i = 0; i < 8; i++) {
-        WRITE_REG(REG_STATE_IN_BASE(base) + i * 4, ctx->state[i]);
+        WRITE_REG(REG_STATE_IN_BASE(base) + i * 4, state[i]);
     }
+}
+
+// ------------------------
+// Write one 512-bit block and its input state into a register window
+// ------------------------
+static void SHA256WriteBlock(uint base, uchar data[], uint state[]) {
+    SHA256WriteMsg(base, data);
+    SHA256WriteState(base, state);
+}
 
-    // Trigger accelerator to begin processing
-    WRITE_REG(REG_CONTROL(base), 0);        // Clear control register
-    WRITE_REG(REG_CONTROL(base), CTRL_GO);  // Set GO bit
+// ------------------------
+// Send one 512-bit block to the accelerator without waiting for the result
+// ------------------------
+#if SHA256_CHAINED
+void SHA256TransformStart(SHA256_CTX *ctx, uchar data[]) {
+    uint base = SHA256_CTX_BASE(ctx);
 
-    // Wait for DONE bit to be set by hardware
-    while ((READ_REG(REG_CONTROL(base)) & CTRL_DONE) == 0) {}
+    // Wait while both banks are taken: by this stream's earlier blocks or, with
+    // context slots, by another stream sharing the core (the fill bank may
+    // still be queued even though this stream has nothing pending)
+    if (ctx->pending || SHA256_CTX_SLOTS > 1) {
+        while (SHA256_CORE_FULL(base)) {}
+    }
+    if (ctx->pending) {
+        // The previous block's result stays in the core: queue this block
+        // behind it with CONTINUE
+        SHA256WriteMsg(base, data);
+        WRITE_REG(REG_CONTROL(base), CTRL_GO | CTRL_CONTINUE | SHA256_CTX_GO(ctx));
+        ctx->open = 1;
+    } else {
+        // First block of a stream (or after a readback): send the state too,
+        // unless the core takes it from an HMAC key slot
+        SHA256WriteMsg(base, data);
+        if (!(ctx->mode & CTRL_IPAD)) SHA256WriteState(base, ctx->state);
+        WRITE_REG(REG_CONTROL(base), CTRL_GO | ctx->mode | SHA256_CTX_GO(ctx));  // Set GO bit (clears DONE)
+        ctx->mode &= ~CTRL_IPAD;
+        ctx->open = 0;
+    }
+    ctx->pending = 1;
+}
+#else
+void SHA256TransformStart(SHA256_CTX *ctx, uchar data[]) {
+    uint base = SHA256_CTX_BASE(ctx);
 
-    // Read the updated SHA256 state from accelerator
+    // No chaining: collect the previous result, then send it back as state_in
+    SHA256TransformWait(ctx);
+    SHA256WriteBlock(base, data, ctx->state);
+    WRITE_REG(REG_CONTROL(base), CTRL_GO | SHA256_CTX_GO(ctx));
+    ctx->pending = 1;
+}
+#endif
+
+// ------------------------
+// Submit one block through the shared job dispatcher; returns the core that took it
+// ------------------------
+uint SHA256JobSubmit(uchar data[], uint state[]) {
+    // The staging window can only be refilled once the previous job was dispatched
+    while (READ_REG(REG_CONTROL(REG_JOB_BASE)) & JOB_PENDING) {}
+
+    SHA256WriteBlock(REG_JOB_BASE, data, state);
+    WRITE_REG(REG_CONTROL(REG_JOB_BASE), CTRL_GO);
+
+    // Hardware copies the job into the first idle core
+    uint job;
+    while ((job = READ_REG(REG_CONTROL(REG_JOB_BASE))) & JOB_PENDING) {}
+    return JOB_CORE(job);
+}
+
+// ------------------------
+// Collect the result of a dispatched job and release its core
+// ------------------------
+void SHA256JobCollect(uint core, uint state[]) {
+    uint base = REG_BASE(core);
+
+    SHA256WaitCore(base, 1);
     for (int i = 0; i < 8; i++) {
-        ctx->state[i] = READ_REG(REG_STATE_OUT_BASE(base) + i * 4);
+        state[i] = READ_REG(REG_STATE_OUT_BASE(base) + i * 4);
     }
+    WRITE_REG(REG_CONTROL(base), 0);  // Clear DONE so the dispatcher can reuse the core
 }
 
 // ------------------------
-// Initialize SHA256 state constants
+// Hold the cores not in mask with their clocks stopped; the job dispatcher
+// skips them. Idle cores gate themselves anyway, so this only matters for
+// keeping cores out of use. The multi-core helpers assume all cores enabled.
 // ------------------------
-void SHA256Init(SHA256_CTX *ctx) {
+void SHA256CoreEnable(uint mask) {
+    WRITE_REG(REG_CORE_ENABLE, mask & ((1u << NUM_CORES) - 1));
+}
+
+// ------------------------
+// Submit one block as a tagged job without waiting; returns 0 if the staging
+// window still holds the previous job
+// ------------------------
+int SHA256JobSubmitTagged(uchar data[], uint state[], uint tag) {
+    if (READ_REG(REG_CONTROL(REG_JOB_BASE)) & JOB_PENDING) return 0;
+
+    SHA256WriteBlock(REG_JOB_BASE, data, state);
+    WRITE_REG(REG_CONTROL(REG_JOB_BASE), CTRL_GO | JOB_TAGGED | JOB_TAG(tag));
+    return 1;
+}
+
+// ------------------------
+// Take the oldest tagged completion; returns 0 if none is waiting
+// ------------------------
+int SHA256JobRetire(uint *tag, uint state[]) {
+    if (!(READ_REG(REG_CONTROL(REG_JOB_BASE)) & JOB_RESULT)) return 0;
+
+    *tag = READ_REG(REG_JOB_TAG);
+    for (int i = 0; i < 8; i++) {
+        state[i] = READ_REG(REG_STATE_OUT_BASE(REG_JOB_BASE) + i * 4);
+    }
+    WRITE_REG(REG_JOB_POP, 0);
+    return 1;
+}
+
+// ------------------------
+// Push one tagged block into the pipelined core; returns 0 if it has no room
+// ------------------------
+int SHA256PipeSubmit(uchar data[], uint state[], uint tag) {
+    if (READ_REG(REG_CONTROL(REG_PIPE_BASE)) & PIPE_FULL) return 0;
+
+    SHA256WriteBlock(REG_PIPE_BASE, data, state);
+    WRITE_REG(REG_CONTROL(REG_PIPE_BASE), PIPE_GO(tag));
+    return 1;
+}
+
+// ------------------------
+// Pop the oldest finished block from the pipelined core; returns 0 if none is ready
+// ------------------------
+int SHA256PipeCollect(uint *tag, uint state[]) {
+    uint ctrl = READ_REG(REG_CONTROL(REG_PIPE_BASE));
+    if ((ctrl & PIPE_RESULT) == 0) return 0;
+
+    *tag = PIPE_TAG(ctrl);
+    for (int i = 0; i < 8; i++) {
+        state[i] = READ_REG(REG_STATE_OUT_BASE(REG_PIPE_BASE) + i * 4);
+    }
+    WRITE_REG(REG_PIPE_POP, 0);
+    return 1;
+}
+
+// ------------------------
+// Hash len bytes at src on the given core with the DMA engine and store the
+// 32-byte digest at hash; src and hash must be 4-byte aligned. Returns 0 on a bus error
+// or when core is not built
+// ------------------------
+int SHA256Dma(const uchar *src, uint len, uchar hash[], uint core) {
+    assert(core < NUM_CORES);
+    while (READ_REG(REG_DMA_CONTROL) & DMA_BUSY) {}
+
+    WRITE_REG(REG_DMA_CONTROL, DMA_CORE(core));
+    WRITE_REG(REG_DMA_SRC, (uint) src);
+    WRITE_REG(REG_DMA_LEN, len);
+    WRITE_REG(REG_DMA_DST, (uint) hash);  // Starts the transfer
+
+    uint ctrl;
+#ifdef SHA256_USE_IRQ
+    SHA256WaitIrq(IRQ_DMA);  // Also raised on a bus error or a refused start
+    SHA256IrqForget(1u << core);  // The job's FINAL interrupted long before the digest store ended
+#endif
+    while ((ctrl = READ_REG(REG_DMA_CONTROL)) & DMA_BUSY) {}
+    WRITE_REG(REG_CONTROL(REG_BASE(core)), 0);  // Release the core (clears DONE)
+    return (ctrl & (DMA_BUS_ERROR | DMA_CORE_ERROR)) == 0;
+}
+
+// ------------------------
+// Sweep count nonces from start over a fixed midstate with the nonce engine.
+// block is the padded last block, its word nonce_word is replaced by the
+// nonce; a digest <= target (word 0 most significant) is a match. Matches are
+// drained while the sweep runs; up to max_found land in found[]. Returns the
+// number of matches, or -1 if the engine had to drop one
+// ------------------------
+int SHA256NonceSweep(uint midstate[], uchar block[], uint nonce_word, uint flags,
+                     uint start, uint count, uint target[], uint found[], uint max_found) {
+    uint ctrl, n = 0;
+
+    for (int i = 0, j = 0; i < 16; ++i, j += 4) {
+        WRITE_REG(REG_NONCE_TEMPLATE + i * 4,
+                  (block[j] << 24) | (block[j+1] << 16) | (block[j+2] << 8) | (block[j+3]));
+    }
+    for (int i = 0; i < 8; i++) {
+        WRITE_REG(REG_NONCE_MIDSTATE + i * 4, midstate[i]);
+        WRITE_REG(REG_NONCE_TARGET + i * 4, target[i]);
+    }
+    WRITE_REG(REG_NONCE_START, start);
+    WRITE_REG(REG_NONCE_COUNT, count);
+    WRITE_REG(REG_NONCE_CONTROL, NONCE_GO | NONCE_WORD(nonce_word) |
+              (flags & (NONCE_DOUBLE | NONCE_LE | NONCE_CMP_LE)));
+
+    do {
+        ctrl = READ_REG(REG_NONCE_CONTROL);
+        for (uint k = NONCE_FOUND_COUNT(ctrl); k > 0; k--) {
+            uint nonce = READ_REG(REG_NONCE_FOUND);
+            WRITE_REG(REG_NONCE_FOUND_POP, 0);
+            if (n < max_found) found[n] = nonce;
+            n++;
+        }
+    } while ((ctrl & NONCE_BUSY) || NONCE_FOUND_COUNT(ctrl));
+
+    return (ctrl & NONCE_FOUND_OVF) ? -1 : (int) n;
+}
+
+// ------------------------
+// Read 8 words through the little-endian view into a digest in memory order
+// ------------------------
+static void SHA256ReadDigest(uint addr, uchar hash[]) {
+    for (int i = 0; i < 8; i++) {
+        uint w = READ_REG(REG_LE_VIEW(addr) + i * 4);
+        memcpy(hash + i * 4, &w, 4);
+    }
+}
+
+// ------------------------
+// Merkle root of count 32-byte leaf digests with the Merkle engine.
+// Word-aligned leaf buffers are fetched by the engine, others are written
+// through the little-endian view. flags may hold MERKLE_DUP_ODD. If path is
+// not NULL it receives the sibling of leaf index at each level, and
+// *path_valid one bit per level that had a sibling. Returns the depth of the
+// tree (path entries), or -1 on a bus error
+// ------------------------
+int SHA256MerkleRoot(uchar leaves[][32], uint count, uint flags, uint index,
+                     uchar root[], uchar path[][32], uint *path_valid) {
+    uint ctrl, depth;
+
+    while (READ_REG(REG_MERKLE_CONTROL) & MERKLE_BUSY) {}
+
+    WRITE_REG(REG_MERKLE_COUNT, count);
+    WRITE_REG(REG_MERKLE_INDEX, index);
+    flags &= MERKLE_DUP_ODD;
+    if (((uint) leaves & 3) == 0) {
+        WRITE_REG(REG_MERKLE_SRC, (uint) leaves);
+        flags |= MERKLE_LOAD;
+    } else {
+        WRITE_REG(REG_MERKLE_LEAF_PTR, 0);
+        for (uint i = 0; i < count * 8; i++) {
+            uint w;
+            memcpy(&w, leaves[0] + i * 4, 4);
+            WRITE_REG(REG_LE_VIEW(REG_MERKLE_LEAF_DATA), w);
+        }
+    }
+    WRITE_REG(REG_MERKLE_CONTROL, MERKLE_GO | flags);
+
+#ifdef SHA256_USE_IRQ
+    SHA256WaitIrq(IRQ_MERKLE);  // Also raised when the leaf fetch fails
+#endif
+    while ((ctrl = READ_REG(REG_MERKLE_CONTROL)) & MERKLE_BUSY) {}
+    if (ctrl & MERKLE_BUS_ERROR) return -1;
+
+    depth = MERKLE_DEPTH(ctrl);
+    SHA256ReadDigest(REG_MERKLE_ROOT, root);
+    if (path) {
+        for (uint l = 0; l < depth; l++) {
+            WRITE_REG(REG_MERKLE_PATH_LEVEL, l);
+            SHA256ReadDigest(REG_MERKLE_PATH, path[l]);
+        }
+        if (path_valid) *path_valid = READ_REG(REG_MERKLE_PATH_VALID);
+    }
+    return (int) depth;
+}
+
+#else
+// ------------------------
+// Software backend: the block is hashed on the spot, nothing is in flight
+// ------------------------
+void SHA256TransformStart(SHA256_CTX *ctx, uchar data[]) {
+    SHA256SoftTransform(ctx->state, data);
+}
+
+void SHA256TransformWait(SHA256_CTX *ctx) {
+    (void) ctx;
+}
+#endif
+
+// ------------------------
+// Send one 512-bit block to the accelerator and wait for the result
+// ------------------------
+void SHA256Transform(SHA256_CTX *ctx, uchar data[]) {
+    SHA256TransformStart(ctx, data);
+    SHA256TransformWait(ctx);
+}
+
+// ------------------------
+// Initialize SHA256 state constants for a stream kept in context slot cid of
+// the given core. Streams in different slots of one core can be updated in
+// any interleaving; each block chains from its own slot
+// ------------------------
+void SHA256InitContext(SHA256_CTX *ctx, uint core, uint cid) {
     memset(ctx, 0, sizeof(SHA256_CTX));
-    ctx->state[0] = 0x6a09e667;
-    ctx->state[1] = 0xbb67ae85;
-    ctx->state[2] = 0x3c6ef372;
-    ctx->state[3] = 0xa54ff53a;
-    ctx->state[4] = 0x510e527f;
-    ctx->state[5] = 0x9b05688c;
-    ctx->state[6] = 0x1f83d9ab;
-    ctx->state[7] = 0x5be0cd19;
+    ctx->base = REG_BASE(core);
+    ctx->cid = cid;
+    memcpy(ctx->state, SHA256_IV, sizeof(SHA256_IV));
+}
+
+// ------------------------
+// Initialize SHA256 state constants for a stream served by the given core
+// ------------------------
+void SHA256InitCore(SHA256_CTX *ctx, uint core) {
+    SHA256InitContext(ctx, core, 0);
+}
+
+// ------------------------
+// Initialize SHA256 state constants (core 0)
+// ------------------------
+void SHA256Init(SHA256_CTX *ctx) {
+    SHA256InitCore(ctx, 0);
+}
+
+// ------------------------
+// State after the first nblocks 64-byte blocks of data (the midstate of a
+// fixed prefix), computed on core 0
+// ------------------------
+void SHA256Midstate(uchar data[], uint nblocks, uint midstate[]) {
+    SHA256_CTX ctx;
+
+    SHA256InitCore(&ctx, 0);
+    for (uint i = 0; i < nblocks; i++) {
+        SHA256TransformStart(&ctx, data + i * 64);
+    }
+    SHA256TransformWait(&ctx);
+    for (int i = 0; i < 8; i++) {
+        midstate[i] = ctx.state[i];
+    }
+#if SHA256_HW
+    WRITE_REG(REG_CONTROL(ctx.base), 0);  // Clear DONE so the dispatcher can reuse the core
+#endif
 }
 
 // ------------------------
 // Process input data in 64-byte blocks
 // ------------------------
 void SHA256Update(SHA256_CTX *ctx, uchar *data, uint len) {
-    uint i;
-    for (i = 0; i < len; ++i) {
-        ctx->data[ctx->datalen++] = data[i];
-
-        // When a full 64-byte block is filled, send it to accelerator
-        if (ctx->datalen == 64) {
-            SHA256Transform(ctx, ctx->data);
-            DBL_INT_ADD(ctx->bitlen[0], ctx->bitlen[1], 512);  // Add 512 bits
-            ctx->datalen = 0;
-        }
+    uint i = 0;
+
+    // Head: top up a partially filled block first
+    // (results are collected by the next block or by SHA256Final)
+    if (ctx->datalen) {
+        while (i < len && ctx->datalen < 64) ctx->data[ctx->datalen++] = data[i++];
+        if (ctx->datalen < 64) return;
+
+        SHA256TransformStart(ctx, ctx->data);
+        DBL_INT_ADD(ctx->bitlen[0], ctx->bitlen[1], 512);  // Add 512 bits
+        ctx->datalen = 0;
+    }
+
+    // Full blocks go straight from the caller's buffer to the msg registers
+    for (; len - i >= 64; i += 64) {
+        SHA256TransformStart(ctx, data + i);
+        DBL_INT_ADD(ctx->bitlen[0], ctx->bitlen[1], 512);
     }
+
+    // Tail: keep the rest for the next call or SHA256Final
+    while (i < len) ctx->data[ctx->datalen++] = data[i++];
 }
 
+#if SHA256_HW && SHA256_CHAINED
 // ------------------------
-// Add padding and finalize the hash
+// Send the remaining bytes as a FINAL block without waiting for the result;
+// the core adds the padding and, past 55 bytes, the extra length block
 // ------------------------
-void SHA256Final(SHA256_CTX *ctx, uchar hash[]) {
-    uint i = ctx->datalen;
+void SHA256FinalStart(SHA256_CTX *ctx) {
+    uint base = SHA256_CTX_BASE(ctx);
+    uint n = ctx->datalen;
+    uint ctrl = CTRL_GO | CTRL_FINAL | CTRL_NBYTES(n) | ctx->mode | SHA256_CTX_GO(ctx);
 
     // Update total bit length
     DBL_INT_ADD(ctx->bitlen[0], ctx->bitlen[1], ctx->datalen * 8);
 
-    // Append padding: 0x80 followed by zeros
-    ctx->data[i++] = 0x80;
-    if (i > 56) {
-        while (i < 64) ctx->data[i++] = 0x00;
-        SHA256Transform(ctx, ctx->data);  // Process current block
-        i = 0;
+    if (ctx->pending || SHA256_CTX_SLOTS > 1) {
+        while (SHA256_CORE_FULL(base)) {}   // As in SHA256TransformStart
+    }
+    if (ctx->pending) {
+        ctrl |= CTRL_CONTINUE;
+    } else if (!(ctx->mode & CTRL_IPAD)) {
+        SHA256WriteState(base, ctx->state);
+    }
+    ctx->mode &= ~CTRL_IPAD;
+
+    // Only the words holding message bytes (ctx->data is word-aligned); bytes past n are ignored,
+    // so a 64-byte-aligned message ends with the control write alone
+    for (uint i = 0; i * 4 < n; ++i) {
+        WRITE_REG(REG_MSG_BASE(REG_LE_VIEW(base)) + i * 4, ((uint *) ctx->data)[i]);
+    }
+    if (ctx->restarted) {
+        WRITE_REG(REG_BITLEN_HI(base), ctx->bitlen[1]);
+        WRITE_REG(REG_BITLEN_LO(base), ctx->bitlen[0]);
+    } else {
+        ctrl |= CTRL_AUTO_LEN;  // Every block of the stream went through this core
+    }
+    WRITE_REG(REG_CONTROL(base), ctrl);
+    ctx->pending = 1;
+    ctx->open = 0;
+}
+
+// ------------------------
+// Wait for the final block and produce the hash
+// ------------------------
+void SHA256FinalWait(SHA256_CTX *ctx, uchar hash[]) {
+    uint base = SHA256_CTX_BASE(ctx);
+
+    SHA256WaitCore(base, 1);
+    SHA256_CTX_SELECT(base, ctx);
+
+    // The little-endian view returns each state word byte-swapped, so storing
+    // it as a native word lays the digest out in memory order
+    for (int i = 0; i < 8; i++) {
+        uint w = READ_REG(REG_STATE_OUT_BASE(REG_LE_VIEW(base)) + i * 4);
+        memcpy(hash + i * 4, &w, 4);
+    }
+    ctx->pending = 0;
+}
+#else
+// ------------------------
+// Pad the remaining bytes in software and send the 1 or 2 tail blocks
+// (software backend, or cores without FINAL)
+// ------------------------
+void SHA256FinalStart(SHA256_CTX *ctx) {
+    uchar tail[128];
+
+    DBL_INT_ADD(ctx->bitlen[0], ctx->bitlen[1], ctx->datalen * 8);
+
+    uint nblk = SHA256PadTail(ctx->data, ctx->datalen, ctx->bitlen, tail);
+    for (uint b = 0; b < nblk; b++) {
+        SHA256TransformStart(ctx, tail + b * 64);
     }
-    while (i < 56) ctx->data[i++] = 0x00;
+}
 
-    // Append total length (64 bits, big-endian)
-    ctx->data[63] = ctx->bitlen[0];
-    ctx->data[62] = ctx->bitlen[0] >> 8;
-    ctx->data[61] = ctx->bitlen[0] >> 16;
-    ctx->data[60] = ctx->bitlen[0] >> 24;
-    ctx->data[59] = ctx->bitlen[1];
-    ctx->data[58] = ctx->bitlen[1] >> 8;
-    ctx->data[57] = ctx->bitlen[1] >> 16;
-    ctx->data[56] = ctx->bitlen[1] >> 24;
+// ------------------------
+// Wait for the last tail block and produce the hash; CTRL_DOUBLE hashes the
+// digest once more
+// ------------------------
+void SHA256FinalWait(SHA256_CTX *ctx, uchar hash[]) {
+    SHA256TransformWait(ctx);
+    SHA256StateBytes(ctx->state, hash);
 
-    // Final block
-    SHA256Transform(ctx, ctx->data);
+    if (ctx->mode & CTRL_DOUBLE) {
+        uchar tail[128];
 
-    // Convert state to final hash output (32 bytes)
-    for (i = 0; i < 4; ++i) {
-        hash[i]      = (ctx->state[0] >> (24 - i * 8)) & 0xff;
-        hash[i + 4]  = (ctx->state[1] >> (24 - i * 8)) & 0xff;
-        hash[i + 8]  = (ctx->state[2] >> (24 - i * 8)) & 0xff;
-        hash[i + 12] = (ctx->state[3] >> (24 - i * 8)) & 0xff;
-        hash[i + 16] = (ctx->state[4] >> (24 - i * 8)) & 0xff;
-        hash[i + 20] = (ctx->state[5] >> (24 - i * 8)) & 0xff;
-        hash[i + 24] = (ctx->state[6] >> (24 - i * 8)) & 0xff;
-        hash[i + 28] = (ctx->state[7] >> (24 - i * 8)) & 0xff;
+        SHA256SoftPad(hash, 32, tail);
+        memcpy(ctx->state, SHA256_IV, sizeof(SHA256_IV));
+        SHA256Transform(ctx, tail);
+        SHA256StateBytes(ctx->state, hash);
     }
 }
+#endif
 
 // ------------------------
-// One-shot SHA256 interface: input a string, return hex digest
+// Add padding and finalize the hash
 // ------------------------
-char* SHA256(char* data) {
+void SHA256Final(SHA256_CTX *ctx, uchar hash[]) {
+    SHA256FinalStart(ctx);
+    SHA256FinalWait(ctx, hash);
+}
+
+// ------------------------
+// Hash two independent messages at the same time, one on each core (or in
+// two context slots of core 0 with a single core)
+// ------------------------
+void SHA256Dual(uchar *data0, uint len0, uchar hash0[],
+                uchar *data1, uint len1, uchar hash1[]) {
+    SHA256_CTX ctx0, ctx1;
+#if SHA256_HW && (NUM_CORES > 1 || (SHA256_CHAINED && SHA256_CTX_SLOTS > 1))
+    uint off0 = 0, off1 = 0;
+
+    SHA256InitCore(&ctx0, 0);
+#if NUM_CORES > 1
+    SHA256InitCore(&ctx1, 1);
+#else
+    SHA256InitContext(&ctx1, 0, 1);  // Blocks of both streams queue on the one core
+#endif
+
+    // Feed both streams one block at a time so that the MMIO writes for
+    // one core overlap the compression running on the other
+    while (off0 < len0 || off1 < len1) {
+        uint n0 = (len0 - off0 > 64) ? 64 : len0 - off0;
+        uint n1 = (len1 - off1 > 64) ? 64 : len1 - off1;
+
+        SHA256Update(&ctx0, data0 + off0, n0);
+        SHA256Update(&ctx1, data1 + off1, n1);
+        off0 += n0;
+        off1 += n1;
+    }
+
+    SHA256FinalStart(&ctx0);
+    SHA256FinalStart(&ctx1);
+    SHA256FinalWait(&ctx0, hash0);
+    SHA256FinalWait(&ctx1, hash1);
+#else
+    // Single core or software: one message after the other
+    SHA256InitCore(&ctx0, 0);
+    SHA256Update(&ctx0, data0, len0);
+    SHA256Final(&ctx0, hash0);
+    SHA256InitCore(&ctx1, 0);
+    SHA256Update(&ctx1, data1, len1);
+    SHA256Final(&ctx1, hash1);
+#endif
+}
+
+#if SHA256_HW && SHA256_CHAINED && SHA256_JOB_FIFO
+// ------------------------
+// Hash count independent messages as tagged jobs: up to JOB_SLOTS messages
+// are in flight, each with one block queued at a time, and every completion
+// is retired as it arrives. A long message never holds a core between its
+// blocks, so short messages in the same batch finish around it
+// ------------------------
+void SHA256Jobs(SHA256_MSG msgs[], uint count, uchar digests[][32]) {
+    uint state[JOB_SLOTS][8];
+    uint job[JOB_SLOTS];     // Message served by each slot
+    uint off[JOB_SLOTS];     // Bytes of it already sent, len + 1 once finalized
+    uint used = 0;           // Bit s = slot s has a message
+    uint busy = 0;           // Bit s = slot s has a job in flight
+    uint next = 0;
+
+    while (next < count || used) {
+        // Submit the next block of every idle slot while the staging window is free
+        for (uint s = 0; s < JOB_SLOTS; s++) {
+            if (busy & (1u << s)) continue;
+            if (!(used & (1u << s))) {
+                if (next == count) continue;
+                memcpy(state[s], SHA256_IV, sizeof(SHA256_IV));
+                job[s] = next++;
+                off[s] = 0;
+                used |= 1u << s;
+            }
+            if (READ_REG(REG_CONTROL(REG_JOB_BASE)) & JOB_PENDING) break;
+
+            SHA256_MSG *m = &msgs[job[s]];
+            uint left = m->len - off[s];
+            if (left >= 64) {
+                SHA256WriteBlock(REG_JOB_BASE, m->data + off[s], state[s]);
+                WRITE_REG(REG_CONTROL(REG_JOB_BASE), CTRL_GO | JOB_TAGGED | JOB_TAG(s));
+                off[s] += 64;
+            } else {
+                // Last block: the dispatcher pads it like a FINAL block in a core window
+                uint tail[16];
+                memcpy(tail, m->data + off[s], left);
+                for (uint i = 0; i * 4 < left; ++i) {
+                    WRITE_REG(REG_MSG_BASE(REG_LE_VIEW(REG_JOB_BASE)) + i * 4, tail[i]);
+                }
+                SHA256WriteState(REG_JOB_BASE, state[s]);
+                WRITE_REG(REG_BITLEN_HI(REG_JOB_BASE), m->len >> 29);
+                WRITE_REG(REG_BITLEN_LO(REG_JOB_BASE), m->len << 3);
+                WRITE_REG(REG_CONTROL(REG_JOB_BASE), CTRL_GO | CTRL_FINAL | CTRL_NBYTES(left) |
+                          JOB_TAGGED | JOB_TAG(s));
+                off[s] = m->len + 1;
+            }
+            busy |= 1u << s;
+        }
+
+        // Retire whatever finished, in completion order
+        uint s, out[8];
+        while (SHA256JobRetire(&s, out)) {
+            busy &= ~(1u << s);
+            if (off[s] > msgs[job[s]].len) {
+                SHA256StateBytes(out, digests[job[s]]);
+                used &= ~(1u << s);
+            } else {
+                memcpy(state[s], out, sizeof(out));
+            }
+        }
+    }
+}
+#endif
+
+// ------------------------
+// SHA256Batch() with the CPU as one more worker. The cores take messages
+// from the front of the list, the CPU steals from the back. The CPU only
+// works when a full pass over the cores made no progress (every core has
+// both banks queued or is finishing), and then one block at a time, so it
+// never holds up feeding a core for more than a software block. It only
+// steals messages up to SHA256_SW_MAX_LEN bytes: a software block costs far
+// more CPU time than sending one to a core
+// ------------------------
+void SHA256Hybrid(SHA256_MSG msgs[], uint count, uchar digests[][32]) {
+#if SHA256_HW
+    SHA256_CTX ctx[NUM_CORES];
+    uint job[NUM_CORES];     // Message served by each core
+    uint off[NUM_CORES];     // Bytes of it already sent, len + 1 once finalized
+    uint active = 0;         // Bit c = core c has a message
+    uint next = 0;           // Next message for a core
+    uint last = count;       // Messages [last, count) went to the CPU
+    uint sw_job = 0, sw_off = 0, sw_busy = 0;
+    uint sw_state[8];
+
+    while (next < last || active || sw_busy) {
+        uint progress = 0;
+
+        for (uint c = 0; c < NUM_CORES; c++) {
+            uint base = REG_BASE(c);
+
+            if (!(active & (1u << c))) {
+                if (next == last) continue;
+                SHA256InitCore(&ctx[c], c);
+                job[c] = next++;
+                off[c] = 0;
+                active |= 1u << c;
+            }
+
+            SHA256_MSG *m = &msgs[job[c]];
+
+            if (off[c] <= m->len) {
+                if (ctx[c].pending && SHA256_CORE_FULL(base)) continue;
+
+                uint n = (m->len - off[c] > 64) ? 64 : m->len - off[c];
+                SHA256Update(&ctx[c], m->data + off[c], n);
+                off[c] += n;
+                if (n < 64) {
+                    SHA256FinalStart(&ctx[c]);
+                    off[c] = m->len + 1;
+                }
+                progress = 1;
+            } else if ((READ_REG(REG_CONTROL(base)) & (CTRL_DONE | CTRL_BUSY)) == CTRL_DONE) {
+                SHA256FinalWait(&ctx[c], digests[job[c]]);
+                active &= ~(1u << c);
+                progress = 1;
+            }
+        }
+        if (progress) continue;
+
+        // Every core is busy: the CPU takes one block of its own message
+        if (!sw_busy) {
+            if (next == last || msgs[last - 1].len > SHA256_SW_MAX_LEN) continue;
+            sw_job = --last;
+            sw_off = 0;
+            sw_busy = 1;
+            memcpy(sw_state, SHA256_IV, sizeof(sw_state));
+        }
+
+        SHA256_MSG *m = &msgs[sw_job];
+        if (m->len - sw_off >= 64) {
+            SHA256SoftTransform(sw_state, m->data + sw_off);
+            sw_off += 64;
+        } else {
+            SHA256SoftFinal(sw_state, m->data, m->len, digests[sw_job]);
+            sw_busy = 0;
+        }
+    }
+#else
+    // Software backend: the CPU is the only worker
+    for (uint i = 0; i < count; i++) {
+        SHA256SoftBytes(msgs[i].data, msgs[i].len, digests[i]);
+    }
+#endif
+}
+
+// ------------------------
+// Hash count independent messages over all cores and write the raw 32-byte
+// digests to digests[]. Cores are visited round-robin and get one block per
+// visit, so the MMIO writes for one core overlap the compression on the
+// others; a core takes the next message as soon as its last one finished
+// ------------------------
+void SHA256Batch(SHA256_MSG msgs[], uint count, uchar digests[][32]) {
+#if SHA256_BACKEND == SHA256_BACKEND_HW
+    SHA256_CTX ctx[NUM_CORES];
+    uint job[NUM_CORES];     // Message served by each core
+    uint off[NUM_CORES];     // Bytes of it already sent, len + 1 once finalized
+    uint active = 0;         // Bit c = core c has a message
+    uint next = 0;
+
+    while (next < count || active) {
+        for (uint c = 0; c < NUM_CORES; c++) {
+            uint base = REG_BASE(c);
+
+            if (!(active & (1u << c))) {
+                if (next == count) continue;
+                SHA256InitCore(&ctx[c], c);
+                job[c] = next++;
+                off[c] = 0;
+                active |= 1u << c;
+            }
+
+            SHA256_MSG *m = &msgs[job[c]];
+
+            if (off[c] <= m->len) {
+                // Skip the core while both banks are queued instead of waiting on it
+                if (ctx[c].pending && SHA256_CORE_FULL(base)) continue;
+
+                uint n = (m->len - off[c] > 64) ? 64 : m->len - off[c];
+                SHA256Update(&ctx[c], m->data + off[c], n);
+                off[c] += n;
+                if (n < 64) {
+                    SHA256FinalStart(&ctx[c]);
+                    off[c] = m->len + 1;
+                }
+            } else if ((READ_REG(REG_CONTROL(base)) & (CTRL_DONE | CTRL_BUSY)) == CTRL_DONE) {
+                SHA256FinalWait(&ctx[c], digests[job[c]]);
+                active &= ~(1u << c);
+            }
+        }
+    }
+#else
+    SHA256Hybrid(msgs, count, digests);  // Hybrid or software backend
+#endif
+}
+
+#if !(SHA256_HW && SHA256_CHAINED && SHA256_JOB_FIFO)
+// ------------------------
+// No tagged job FIFO: the jobs interface runs as a batch
+// ------------------------
+void SHA256Jobs(SHA256_MSG msgs[], uint count, uchar digests[][32]) {
+    SHA256Batch(msgs, count, digests);
+}
+#endif
+
+// ------------------------
+// Allocation-free one-shot interface: hash len bytes (any binary data) into hash[32]
+// ------------------------
+void SHA256Bytes(uchar *data, uint len, uchar hash[]) {
+    SHA256_CTX ctx;
+
+#if SHA256_DMA
+    // Long word-aligned messages: the DMA engine reads memory itself (MMIO on a bus error)
+    if (len >= SHA256_DMA_MIN_LEN && (((uint) data | (uint) hash) & 3) == 0 &&
+        SHA256Dma(data, len, hash, 0)) return;
+#endif
+    SHA256Init(&ctx);
+    SHA256Update(&ctx, data, len);
+    SHA256Final(&ctx, hash);
+}
+
+// ------------------------
+// SHA256d: SHA256(SHA256(data)); the core hashes the digest again by itself
+// ------------------------
+void SHA256d(uchar *data, uint len, uchar hash[]) {
     SHA256_CTX ctx;
-    unsigned char hash[32];
-    char* hashStr = malloc(65);  // 64 chars + null terminator
-    if (!hashStr) return NULL;
 
     SHA256Init(&ctx);
-    SHA256Update(&ctx, (uchar *)data, strlen(data));
+    ctx.mode = CTRL_DOUBLE;
+    SHA256Update(&ctx, data, len);
     SHA256Final(&ctx, hash);
+}
+
+#if SHA256_HW && SHA256_CHAINED
+// ------------------------
+// Cache a key in an HMAC key slot: the core keeps the midstates after the
+// (key ^ ipad) and (key ^ opad) blocks, so each MAC only sends the message
+// ------------------------
+void SHA256HmacSetKey(uint slot, uchar key[], uint keylen) {
+    uchar k[64], pad[64];
+    uint ipad[8], opad[8];
+
+    memset(k, 0, sizeof(k));
+    if (keylen > 64) {
+        SHA256Bytes(key, keylen, k);  // Long keys are hashed first
+    } else {
+        memcpy(k, key, keylen);
+    }
+
+    for (int i = 0; i < 64; i++) pad[i] = k[i] ^ 0x36;
+    SHA256Midstate(pad, 1, ipad);
+    for (int i = 0; i < 64; i++) pad[i] = k[i] ^ 0x5c;
+    SHA256Midstate(pad, 1, opad);
+
+    for (int i = 0; i < 8; i++) {
+        WRITE_REG(REG_HMAC_IPAD(slot) + i * 4, ipad[i]);
+        WRITE_REG(REG_HMAC_OPAD(slot) + i * 4, opad[i]);
+    }
+}
+
+// ------------------------
+// Start an HMAC-SHA256 stream on a core with the key cached in a slot;
+// SHA256Update/SHA256Final then return the MAC instead of the hash
+// ------------------------
+void SHA256HmacInit(SHA256_CTX *ctx, uint core, uint slot) {
+    SHA256InitCore(ctx, core);
+    ctx->mode = CTRL_HMAC | CTRL_IPAD | CTRL_SLOT(slot);
+    ctx->bitlen[0] = 512;  // The (key ^ ipad) block is already hashed
+}
+
+// ------------------------
+// HMAC-SHA256 of data under the key cached in a slot (core 0)
+// ------------------------
+void SHA256Hmac(uint slot, uchar *data, uint len, uchar mac[]) {
+    SHA256_CTX ctx;
+
+    SHA256HmacInit(&ctx, 0, slot);
+    SHA256Update(&ctx, data, len);
+    SHA256Final(&ctx, mac);
+}
+
+#endif
+
+#if SHA256_HW
+// ------------------------
+// Restart the performance counters
+// ------------------------
+void SHA256PerfReset(void) {
+    WRITE_REG(REG_PERF_CONTROL, PERF_CLEAR);
+}
+
+// ------------------------
+// Snapshot the performance counters into perf, optionally restarting them in
+// the same cycle so back-to-back samples cover consecutive intervals
+// ------------------------
+void SHA256PerfSample(SHA256_PERF *perf, uint clear) {
+    WRITE_REG(REG_PERF_CONTROL, PERF_SNAPSHOT | (clear ? PERF_CLEAR : 0));
+    perf->cycles = READ_REG(REG_PERF_GLOBAL + 0x00);
+    perf->blocks = READ_REG(REG_PERF_GLOBAL + 0x04);
+    perf->reads  = READ_REG(REG_PERF_GLOBAL + 0x08);
+    perf->writes = READ_REG(REG_PERF_GLOBAL + 0x0C);
+    perf->busy   = READ_REG(REG_PERF_GLOBAL + 0x10);
+
+    for (int c = 0; c < NUM_CORES; c++) {
+        WRITE_REG(REG_PERF_CONTROL, PERF_CORE(c));  // Select only, the snapshot stays
+        perf->core[c].blocks   = READ_REG(REG_PERF_CORE + 0x00);
+        perf->core[c].idle     = READ_REG(REG_PERF_CORE + 0x04);
+        perf->core[c].load     = READ_REG(REG_PERF_CORE + 0x08);
+        perf->core[c].expand   = READ_REG(REG_PERF_CORE + 0x0C);
+        perf->core[c].compress = READ_REG(REG_PERF_CORE + 0x10);
+        perf->core[c].done     = READ_REG(REG_PERF_CORE + 0x14);
+        perf->core[c].stall    = READ_REG(REG_PERF_CORE + 0x18);
+        perf->core[c].reads    = READ_REG(REG_PERF_CORE + 0x1C);
+        perf->core[c].writes   = READ_REG(REG_PERF_CORE + 0x20);
+    }
+}
+
+// ------------------------
+// Print a snapshot as a cycle breakdown per core
+// ------------------------
+void SHA256PerfPrint(SHA256_PERF *perf) {
+    printf("Accelerator: %u cycles, %u blocks, %u reg reads, %u reg writes, %u busy\n",
+           perf->cycles, perf->blocks, perf->reads, perf->writes, perf->busy);
+    for (int c = 0; c < NUM_CORES; c++) {
+        printf("  core %d: %u blocks, idle %u load %u expand %u compress %u done %u stall %u,"
+               " %u reads %u writes\n",
+               c, perf->core[c].blocks, perf->core[c].idle, perf->core[c].load,
+               perf->core[c].expand, perf->core[c].compress, perf->core[c].done,
+               perf->core[c].stall, perf->core[c].reads, perf->core[c].writes);
+    }
+}
+
+#endif
+
+// ------------------------
+// Write the 64-character lowercase hex form of a digest plus a NUL into out[65]
+// ------------------------
+void SHA256HexEncode(uchar hash[], char out[]) {
+    static const char hex[] = "0123456789abcdef";
 
-    // Convert binary hash to readable hex string
     for (int i = 0; i < 32; i++) {
-        sprintf(hashStr + i * 2, "%02x", hash[i]);
+        out[i * 2]     = hex[hash[i] >> 4];
+        out[i * 2 + 1] = hex[hash[i] & 0xf];
     }
-    hashStr[64] = '\0';
+    out[64] = '\0';
+}
+
+// ------------------------
+// Convert a binary hash into a newly allocated hex string
+// ------------------------
+static char* SHA256ToHex(uchar hash[]) {
+    char* hashStr = malloc(65);  // 64 chars + null terminator
+    if (!hashStr) return NULL;
 
+    SHA256HexEncode(hash, hashStr);
     return hashStr;
 }
 
+// ------------------------
+// One-shot SHA256 interface: input a string, return hex digest (caller frees)
+// ------------------------
+char* SHA256(char* data) {
+    unsigned char hash[32];
+
+    SHA256Bytes((uchar *)data, strlen(data), hash);
+    return SHA256ToHex(hash);
+}
+
+// ------------------------
+// Two-string SHA256 interface: hashes both strings in parallel on cores 0 and 1
+// ------------------------
+void SHA256Pair(char* data0, char* data1, char** out0, char** out1) {
+    unsigned char hash0[32], hash1[32];
+
+    SHA256Dual((uchar *)data0, strlen(data0), hash0,
+               (uchar *)data1, strlen(data1), hash1);
+
+    *out0 = SHA256ToHex(hash0);
+    *out1 = SHA256ToHex(hash1);
+}
+
+#ifndef SHA256_NO_MAIN
 // ------------------------
 // Main Function (Testbench)
+// Build with -DSHA256_NO_MAIN to link the driver into another program (sha256_bench.c)
 // ------------------------
 int main() {
     // Array of 20 strings to hash
@@ -199,28 +1447,52 @@ int main() {
     };
 
     unsigned int cyc_beg, cyc_end;
-    char *array[20];
+    char hex[20][65];
+    SHA256_MSG msgs[20];
+    uchar digests[20][32];
+#if SHA256_HW
+    SHA256_PERF perf;
+    uint has_perf = READ_REG(REG_ID) & ID_FEAT_PERF;
+#endif
+
+#ifdef SHA256_USE_IRQ
+    SHA256IrqInit();
+#endif
 
     // Enable performance monitoring
     pspMachinePerfMonitorEnableAll();
     pspMachinePerfCounterSet(D_PSP_COUNTER0, D_CYCLES_CLOCKS_ACTIVE);
+#if SHA256_HW
+    if (has_perf) SHA256PerfReset();
+#endif
     cyc_beg = pspMachinePerfCounterGet(D_PSP_COUNTER0);  // Start timing
 
-    // Run SHA256 on all 20 strings using hardware accelerator
+    // Run SHA256 on all 20 strings as one batch spread over the cores
+    for (int i = 0; i < 20; i++) {
+        msgs[i].data = (uchar *)secrets[i];
+        msgs[i].len = strlen(secrets[i]);
+    }
+    SHA256Batch(msgs, 20, digests);
     for (int i = 0; i < 20; i++) {
-        array[i] = SHA256(secrets[i]);
+        SHA256HexEncode(digests[i], hex[i]);
     }
 
     cyc_end = pspMachinePerfCounterGet(D_PSP_COUNTER0);  // Stop timing
+#if SHA256_HW
+    if (has_perf) SHA256PerfSample(&perf, 0);
+#endif
 
     // Print results
     for (int i = 0; i < 20; i++) {
-        printf("public key %d: %s\n", i, array[i]);
-        free(array[i]);  // Free memory after use
+        printf("public key %d: %s\n", i, hex[i]);
     }
 
     printf("\nPerformance Summary\n");
     printf("Total Cycles = %d\n", cyc_end - cyc_beg);  // Show total execution time
+#if SHA256_HW
+    if (has_perf) SHA256PerfPrint(&perf);
+#endif
 
     return 0;
 }
+#endif
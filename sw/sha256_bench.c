@@ -0,0 +1,356 @@
+// ------------------------
+// SHA256 accelerator benchmark
+// Pure-software baseline (SHA256SoftTransform) against each hardware mode of sha256.c:
+//   single  : one block per round trip (state written and read back every block)
+//   chained : CONTINUE chaining with hardware padding (SHA256Bytes)
+//   dual    : two messages at once, one per core (SHA256Dual)
+//   batch   : many messages spread over the cores (SHA256Batch, SHA256Jobs, SHA256Hybrid)
+//   streams : open streams interleaved block by block on core 0, state saved
+//             and restored on every switch ("swap") or kept in context slots ("slots")
+// Every digest is checked against the NIST FIPS 180-2 vectors and against the
+// software baseline. Build this file on its own; it pulls in the driver:
+//   -DBENCH_CPU_HZ=<clock>    clock used for the MB/s column (default 50 MHz)
+//   -DBENCH_MAX_BYTES=<n>     largest message of the size sweep (default 1 MiB)
+// ------------------------
+#define SHA256_NO_MAIN
+#include "sha256.c"
+
+#ifndef BENCH_CPU_HZ
+#define BENCH_CPU_HZ     50000000u
+#endif
+#ifndef BENCH_MAX_BYTES
+#define BENCH_MAX_BYTES  (1u << 20)
+#endif
+#define BENCH_MAX_BATCH  1024
+#define BENCH_BATCH_LEN  64          // Message size of the batch sweep
+#define BENCH_MIN_BYTES  65536       // Small sizes are repeated until this much was hashed
+#define BENCH_STREAM_LEN 4096        // Message size of the stream sweep
+
+static uchar bench_buf[BENCH_MAX_BYTES] __attribute__((aligned(4)));
+static SHA256_MSG bench_msgs[BENCH_MAX_BATCH];
+static uchar bench_hw[BENCH_MAX_BATCH][32];
+static uchar bench_sw[BENCH_MAX_BATCH][32];
+static uint bench_fail;
+
+// ------------------------
+// Software baseline: SHA256SoftTransform, the transform the accelerator replaces
+// ------------------------
+static void SwHash(uchar *data, uint len, uchar hash[]) {
+    SHA256SoftBytes(data, len, hash);
+}
+
+// ------------------------
+// Hardware modes, all with the signature of SwHash
+// ------------------------
+static void HwRoundTrip(uint state[], uchar data[]) {
+    SHA256_CTX ctx;
+
+    SHA256InitCore(&ctx, 0);
+    memcpy(ctx.state, state, sizeof(ctx.state));
+    SHA256Transform(&ctx, data);   // State written, GO, DONE polled, state read back
+    memcpy(state, ctx.state, sizeof(ctx.state));
+}
+
+static void HwSingle(uchar *data, uint len, uchar hash[]) {
+    uint state[8];
+    uchar tail[128];
+    uint nblk = SHA256SoftPad(data, len, tail);   // Padding in software, as originally
+
+    memcpy(state, SHA256_IV, sizeof(state));
+    for (uint i = 0; len - i >= 64; i += 64)
+        HwRoundTrip(state, data + i);
+    for (uint b = 0; b < nblk; b++)
+        HwRoundTrip(state, tail + b * 64);
+    SHA256StateBytes(state, hash);
+}
+
+static void HwChained(uchar *data, uint len, uchar hash[]) {
+    SHA256Bytes(data, len, hash);
+}
+
+static void HwDual(uchar *data, uint len, uchar hash[]) {
+    uchar other[32];
+
+    SHA256Dual(data, len, hash, data, len, other);
+    if (memcmp(hash, other, 32) != 0) memset(hash, 0, 32);  // Shows up as a mismatch
+}
+
+typedef void (*BENCH_FN)(uchar *data, uint len, uchar hash[]);
+
+static const struct {
+    const char *name;
+    BENCH_FN fn;
+    uint hashes;        // Messages hashed per call
+} bench_modes[] = {
+    { "sw",      SwHash,     1 },
+    { "single",  HwSingle,   1 },
+    { "chained", HwChained,  1 },
+    { "dual",    HwDual,     2 },
+};
+#define BENCH_MODES (sizeof(bench_modes) / sizeof(bench_modes[0]))
+
+// ------------------------
+// NIST FIPS 180-2 example vectors (the last one is 1,000,000 x 'a')
+// ------------------------
+static const struct {
+    const char *msg;
+    uint len;
+    const char *digest;
+} nist[] = {
+    { "", 0,
+      "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+    { "abc", 3,
+      "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+    { "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 56,
+      "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+    { "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu", 112,
+      "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1" },
+    { NULL, 1000000,
+      "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0" },
+};
+#define NIST_VECTORS (sizeof(nist) / sizeof(nist[0]))
+
+static void BenchCheck(const char *what, uint arg, uchar got[], const char *want_hex) {
+    char hex[65];
+
+    SHA256HexEncode(got, hex);
+    if (strcmp(hex, want_hex) != 0) {
+        printf("FAIL %s (%u): %s, expected %s\n", what, arg, hex, want_hex);
+        bench_fail++;
+    }
+}
+
+static void BenchNist(void) {
+    for (uint v = 0; v < NIST_VECTORS; v++) {
+        uchar *data = bench_buf;
+
+        if (nist[v].len > BENCH_MAX_BYTES) continue;
+        if (nist[v].msg) memcpy(bench_buf, nist[v].msg, nist[v].len);
+        else memset(bench_buf, 'a', nist[v].len);
+
+        for (uint m = 0; m < BENCH_MODES; m++) {
+            bench_modes[m].fn(data, nist[v].len, bench_hw[0]);
+            BenchCheck(bench_modes[m].name, v, bench_hw[0], nist[v].digest);
+        }
+
+        bench_msgs[0].data = data;
+        bench_msgs[0].len = nist[v].len;
+        SHA256Batch(bench_msgs, 1, bench_hw);
+        BenchCheck("batch", v, bench_hw[0], nist[v].digest);
+        SHA256Jobs(bench_msgs, 1, bench_hw);
+        BenchCheck("jobs", v, bench_hw[0], nist[v].digest);
+        SHA256Hybrid(bench_msgs, 1, bench_hw);
+        BenchCheck("hybrid", v, bench_hw[0], nist[v].digest);
+    }
+    printf("NIST vectors: %s\n", bench_fail ? "FAILED" : "ok");
+}
+
+// ------------------------
+// Timing and report helpers (integer only: two decimals as x100)
+// ------------------------
+static uint BenchNow(void) {
+    return pspMachinePerfCounterGet(D_PSP_COUNTER0);
+}
+
+// "vs sw" compares cycles per hash with the software run of the same size
+static void BenchReport(const char *mode, uint size, uint hashes, uint cycles,
+                        uint sw_cycles, uint sw_hashes) {
+    unsigned long long bytes = (unsigned long long) size * hashes;
+    uint cpb   = bytes ? (uint) ((unsigned long long) cycles * 100 / bytes) : 0;
+    uint mbps  = cycles ? (uint) (bytes * BENCH_CPU_HZ / cycles / 10000) : 0;
+    uint gain  = cycles ? (uint) ((unsigned long long) sw_cycles * hashes * 100
+                                  / ((unsigned long long) cycles * sw_hashes)) : 0;
+
+    printf("%-8s %8u %5u  %6u.%02u %10u %6u.%02u  %4u.%02ux\n", mode, size, hashes,
+           cpb / 100, cpb % 100, cycles / (hashes ? hashes : 1), mbps / 100, mbps % 100,
+           gain / 100, gain % 100);
+}
+
+static void BenchFill(uint seed) {
+    uint x = seed;
+
+    for (uint i = 0; i < BENCH_MAX_BYTES; i++) {
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;   // xorshift32, same data every run
+        bench_buf[i] = (uchar) x;
+    }
+}
+
+// ------------------------
+// Message size sweep: every mode on one message of each size
+// ------------------------
+static void BenchSizes(void) {
+    static const uint sizes[] = {
+        0, 1, 55, 56, 63, 64, 65, 256, 1024, 4096, 16384, 65536, 262144, 1048576
+    };
+    char want[65];
+
+    printf("\n%-8s %8s %5s  %9s %10s %9s  %8s\n",
+           "mode", "bytes", "hash", "cyc/byte", "cyc/hash", "MB/s", "vs sw");
+
+    for (uint s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        uint len = sizes[s];
+        uint reps = (len >= BENCH_MIN_BYTES) ? 1 : BENCH_MIN_BYTES / (len + 64);
+        uint sw_cycles = 0;
+
+        if (len > BENCH_MAX_BYTES) break;
+        SwHash(bench_buf, len, bench_sw[0]);
+        SHA256HexEncode(bench_sw[0], want);
+
+        for (uint m = 0; m < BENCH_MODES; m++) {
+            uint t0 = BenchNow();
+            for (uint r = 0; r < reps; r++)
+                bench_modes[m].fn(bench_buf, len, bench_hw[0]);
+            uint cycles = BenchNow() - t0;
+
+            if (m == 0) sw_cycles = cycles;
+            BenchCheck(bench_modes[m].name, len, bench_hw[0], want);
+            BenchReport(bench_modes[m].name, len, reps * bench_modes[m].hashes, cycles, sw_cycles, reps);
+        }
+    }
+}
+
+// ------------------------
+// Batch size sweep: count messages of BENCH_BATCH_LEN bytes
+// ------------------------
+static void BenchBatches(void) {
+    char want[65];
+
+    printf("\n%-8s %8s %5s  %9s %10s %9s  %8s\n",
+           "mode", "bytes", "batch", "cyc/byte", "cyc/hash", "MB/s", "vs sw");
+
+    for (uint count = 1; count <= BENCH_MAX_BATCH; count *= 2) {
+        uint t0, sw_cycles, cycles;
+
+        if ((unsigned long long) count * BENCH_BATCH_LEN > BENCH_MAX_BYTES) break;
+        for (uint i = 0; i < count; i++) {
+            bench_msgs[i].data = bench_buf + i * BENCH_BATCH_LEN;
+            bench_msgs[i].len = BENCH_BATCH_LEN;
+        }
+
+        t0 = BenchNow();
+        for (uint i = 0; i < count; i++)
+            SwHash(bench_msgs[i].data, BENCH_BATCH_LEN, bench_sw[i]);
+        sw_cycles = BenchNow() - t0;
+        BenchReport("sw", BENCH_BATCH_LEN, count, sw_cycles, sw_cycles, count);
+
+        t0 = BenchNow();
+        SHA256Batch(bench_msgs, count, bench_hw);
+        cycles = BenchNow() - t0;
+        for (uint i = 0; i < count; i++) {
+            SHA256HexEncode(bench_sw[i], want);
+            BenchCheck("batch", count, bench_hw[i], want);
+        }
+        BenchReport("batch", BENCH_BATCH_LEN, count, cycles, sw_cycles, count);
+
+        t0 = BenchNow();
+        SHA256Jobs(bench_msgs, count, bench_hw);
+        cycles = BenchNow() - t0;
+        for (uint i = 0; i < count; i++) {
+            SHA256HexEncode(bench_sw[i], want);
+            BenchCheck("jobs", count, bench_hw[i], want);
+        }
+        BenchReport("jobs", BENCH_BATCH_LEN, count, cycles, sw_cycles, count);
+
+        t0 = BenchNow();
+        SHA256Hybrid(bench_msgs, count, bench_hw);
+        cycles = BenchNow() - t0;
+        for (uint i = 0; i < count; i++) {
+            SHA256HexEncode(bench_sw[i], want);
+            BenchCheck("hybrid", count, bench_hw[i], want);
+        }
+        BenchReport("hybrid", BENCH_BATCH_LEN, count, cycles, sw_cycles, count);
+    }
+}
+
+#if SHA256_HW && SHA256_CHAINED && SHA256_CTX_SLOTS > 1
+// ------------------------
+// Interleaved streams: count messages of BENCH_STREAM_LEN bytes on core 0,
+// one 64-byte SHA256Update() per stream in turn. With one slot every switch
+// reads the running stream's state back; with slots nothing leaves the core
+// ------------------------
+static void BenchStreamRun(uint count, uint slots) {
+    SHA256_CTX ctx[SHA256_CTX_SLOTS];
+
+    for (uint s = 0; s < count; s++)
+        SHA256InitContext(&ctx[s], 0, slots ? s : 0);
+
+    for (uint off = 0; off < BENCH_STREAM_LEN; off += 64) {
+        for (uint s = 0; s < count; s++) {
+            if (!slots && count > 1) {
+                SHA256TransformWait(&ctx[(s + count - 1) % count]);  // Save the previous stream
+            }
+            SHA256Update(&ctx[s], bench_msgs[s].data + off, 64);
+        }
+    }
+    if (!slots && count > 1) SHA256TransformWait(&ctx[count - 1]);
+    for (uint s = 0; s < count; s++) {
+        if (slots) SHA256FinalStart(&ctx[s]);
+        else SHA256Final(&ctx[s], bench_hw[s]);
+    }
+    if (slots) {
+        for (uint s = 0; s < count; s++)
+            SHA256FinalWait(&ctx[s], bench_hw[s]);
+    }
+    WRITE_REG(REG_CONTROL(REG_BASE0), 0);  // Release core 0 for the job dispatcher
+}
+
+static void BenchStreams(void) {
+    char want[65];
+
+    printf("\n%-8s %8s %5s  %9s %10s %9s  %8s\n",
+           "mode", "bytes", "strm", "cyc/byte", "cyc/hash", "MB/s", "vs sw");
+
+    for (uint count = 1; count <= SHA256_CTX_SLOTS; count *= 2) {
+        uint t0, sw_cycles, cycles;
+
+        if ((unsigned long long) count * BENCH_STREAM_LEN > BENCH_MAX_BYTES) break;
+        for (uint i = 0; i < count; i++)
+            bench_msgs[i].data = bench_buf + i * BENCH_STREAM_LEN;
+
+        t0 = BenchNow();
+        for (uint i = 0; i < count; i++)
+            SwHash(bench_msgs[i].data, BENCH_STREAM_LEN, bench_sw[i]);
+        sw_cycles = BenchNow() - t0;
+        BenchReport("sw", BENCH_STREAM_LEN, count, sw_cycles, sw_cycles, count);
+
+        for (uint slots = 0; slots < 2; slots++) {
+            const char *name = slots ? "slots" : "swap";
+
+            t0 = BenchNow();
+            BenchStreamRun(count, slots);
+            cycles = BenchNow() - t0;
+            for (uint i = 0; i < count; i++) {
+                SHA256HexEncode(bench_sw[i], want);
+                BenchCheck(name, count, bench_hw[i], want);
+            }
+            BenchReport(name, BENCH_STREAM_LEN, count, cycles, sw_cycles, count);
+        }
+    }
+}
+#endif
+
+// ------------------------
+// Main Function (Benchmark)
+// ------------------------
+int main() {
+    pspMachinePerfMonitorEnableAll();
+    pspMachinePerfCounterSet(D_PSP_COUNTER0, D_CYCLES_CLOCKS_ACTIVE);
+
+#if SHA256_HW
+    printf("SHA256 benchmark: %u cores, REG_ID %08x, %u Hz\n",
+           NUM_CORES, READ_REG(REG_ID), BENCH_CPU_HZ);
+#else
+    printf("SHA256 benchmark: software backend, %u Hz\n", BENCH_CPU_HZ);
+#endif
+
+    BenchNist();
+    BenchFill(0x2545f491);
+    BenchSizes();
+    BenchBatches();
+#if SHA256_HW && SHA256_CHAINED && SHA256_CTX_SLOTS > 1
+    BenchStreams();
+#endif
+
+    printf("\n%s: %u digest mismatches\n", bench_fail ? "FAILED" : "PASSED", bench_fail);
+    return bench_fail != 0;
+}
@@ -0,0 +1,47 @@
+# =====================================
+# ROUNDS_PER_CYCLE sweep for accelerator_top
+# Re-runs synthesis + place & route for each unroll setting and writes one
+# timing summary and one utilization report per setting into synth/:
+#   accelerator_top_timing_summary_routed_rpc<N>.rpt
+#   accelerator_top_utilization_placed_rpc<N>.rpt
+#
+# Usage (from the repository root):
+#   vivado -mode batch -source synth/sweep_rounds.tcl -tclargs [period_ns] [num_cores] [core_period_ns]
+#   core_period_ns > 0 builds with CORE_CLK = 1 and times the cores on
+#   core_clk_i; the two clocks are declared asynchronous (accelerator_cdc.sv)
+# =====================================
+
+set here   [file dirname [file normalize [info script]]]
+set rtl    [file join $here .. rtl]
+set part   xc7a100tcsg324-1
+
+# Target clock period (ns) used to report slack, and core count to build
+set period    [expr {$argc > 0 ? [lindex $argv 0] : 10.0}]
+set num_cores [expr {$argc > 1 ? [lindex $argv 1] : 2}]
+set core_period [expr {$argc > 2 ? [lindex $argv 2] : 0}]
+set core_clk    [expr {$core_period > 0 ? 1 : 0}]
+
+foreach rpc {1 2 4 8} {
+    puts "=== ROUNDS_PER_CYCLE = $rpc (period ${period} ns, ${num_cores} cores) ==="
+
+    create_project -in_memory -part $part
+    read_verilog -sv [glob [file join $rtl *.sv]]
+
+    # Out-of-context so the report shows the accelerator logic, not pad timing
+    synth_design -top accelerator_top -part $part -mode out_of_context \
+        -generic ROUNDS_PER_CYCLE=$rpc -generic NUM_CORES=$num_cores \
+        -generic CORE_CLK=$core_clk
+    create_clock -name wb_clk_i -period $period [get_ports wb_clk_i]
+    if {$core_clk} {
+        create_clock -name core_clk_i -period $core_period [get_ports core_clk_i]
+        set_clock_groups -asynchronous -group wb_clk_i -group core_clk_i
+    }
+
+    opt_design
+    place_design
+    report_utilization -file [file join $here accelerator_top_utilization_placed_rpc${rpc}.rpt]
+    route_design
+    report_timing_summary -max_paths 10 -file [file join $here accelerator_top_timing_summary_routed_rpc${rpc}.rpt]
+
+    close_project
+}